@@ -0,0 +1,310 @@
+#include "allocationReport.hpp"
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// Układ formatu binarnego (liczby w natywnej kolejności bajtów, każda sekcja
+// wyrównana do 8 bajtów):
+//   ReportHeader
+//   etykiety typów, każda zakończona '\0' (labelsLength bajtów)
+//   rekordy (nRecords x 32 bajty, zapisywane pole po polu, patrz
+//   writeRecord - bajty wyrównania z pamięci nie trafiają do pliku)
+
+namespace {
+
+const char reportMagic[8] = {'T', 'G', 'R', 'E', 'P', 'R', 'T', '1'};
+const std::uint32_t reportVersion = 1;
+
+struct ReportHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::int32_t mode;
+  std::int32_t nTypes;
+  std::int32_t nRecords;
+  std::uint32_t labelsLength;
+  std::uint32_t hasTotals;
+  double overallTime;
+  double overallCost;
+};
+
+static_assert(sizeof(ReportHeader) == 48, "no padding in ReportHeader");
+
+// Dopisywanie do bufora bez strumieni: liczby przez to_chars
+class Buffer {
+ private:
+  std::string& data;
+ public:
+  explicit Buffer(std::string& data_) : data{data_} {}
+  Buffer& operator<<(std::string_view text) {
+    data.append(text);
+    return *this;
+  }
+  Buffer& operator<<(char c) {
+    data.push_back(c);
+    return *this;
+  }
+  Buffer& operator<<(int value) {
+    char digits[16];
+    auto end = std::to_chars(digits, digits + sizeof digits, value).ptr;
+    data.append(digits, end);
+    return *this;
+  }
+  void number(double value, int precision) {
+    // precision 6 - tak jak domyślnie std::ostream (%g), 0 - najkrótszy
+    // zapis, z którego odczyt daje dokładnie tę samą liczbę
+    char digits[32];
+    auto end = precision > 0
+      ? std::to_chars(digits, digits + sizeof digits, value,
+                      std::chars_format::general, precision).ptr
+      : std::to_chars(digits, digits + sizeof digits, value).ptr;
+    data.append(digits, end);
+  }
+  void bytes(const void* source, std::size_t size) {
+    data.append(static_cast<const char*>(source), size);
+    data.append((8 - data.size() % 8) % 8, '\0');
+  }
+};
+
+void writeLabel(Buffer& out, const AllocationReport& report,
+                const ReportRecord& record) {
+  out << report.typeLabels[record.procID];
+  if (record.instance != -1)
+    out << '_' << record.instance;
+}
+
+void writeText(const AllocationReport& report, bool colored, Buffer& out) {
+  if (colored) {
+    if (report.mode == 1)
+      out << "\n\e[32m\e[1mAlokacja zasobów metodą standaryzacji:\e[0m\n";
+    else if (report.mode == 3)
+      out << "\n\e[32m\e[1mAlokacja zasobów metodą HEFT "
+          << "(upward rank):\e[0m\n";
+    else
+      out << "\n\e[32m\e[1mPoczątkowy przydział zasobów\e[0m\n";
+  }
+  RecordKind previous = RECORD_SCHEDULED;
+  bool hasSchedule = report.mode == 2;
+  for (const auto& record : report.records) {
+    switch (record.kind) {
+      case RECORD_RECOMPUTED:
+        if (previous != RECORD_RECOMPUTED)
+          out << "Time intervals have been recomputed:\n";
+        [[fallthrough]];
+      case RECORD_ALLOCATED:
+        out << "  T" << record.taskID
+            << (record.kind == RECORD_ALLOCATED ? " --> " : " -> ");
+        writeLabel(out, report, record);
+        out << " [startTime: ";
+        out.number(record.startTime, 6);
+        out << ", endTime: ";
+        out.number(record.endTime, 6);
+        out << "]\n";
+        break;
+      case RECORD_TYPE:
+        out << (record.unpredicted ? "  uT" : "  T") << record.taskID
+            << " --> ";
+        writeLabel(out, report, record);
+        out << '\n';
+        break;
+      case RECORD_SCHEDULED:
+        hasSchedule = true;
+        break;
+    }
+    previous = record.kind;
+  }
+  if (hasSchedule) {
+    out << (colored ? "\n\e[34m\e[1mPoszeregowane zadania "
+                      "(w tym nieprzewidziane):\e[0m\n"
+                    : "schedule:\n");
+    bool first = true;
+    for (const auto& record : report.records) {
+      if (record.kind != RECORD_SCHEDULED)
+        continue;
+      out << (first ? "  " : " --> ") << (record.unpredicted ? "uT" : "T")
+          << record.taskID;
+      first = false;
+    }
+    out << '\n';
+  }
+  if (report.hasTotals) {
+    out << (colored ? "\n\e[34mCałkowity czas wykonania:\e[0m "
+                    : "total time: ");
+    out.number(report.overallTime, 6);
+    out << (colored ? "\n\e[34mCałkowity koszt:\e[0m " : "\ntotal cost: ");
+    out.number(report.overallCost, 6);
+    out << '\n';
+  }
+  if (colored)
+    out << '\n';
+}
+
+const char* kindName(RecordKind kind) {
+  switch (kind) {
+    case RECORD_ALLOCATED: return "allocated";
+    case RECORD_TYPE: return "type";
+    case RECORD_RECOMPUTED: return "recomputed";
+    default: return "scheduled";
+  }
+}
+
+void writeCsvField(Buffer& out, const std::string& text) {
+  if (text.find_first_of(",\"\n") == std::string::npos) {
+    out << text;
+    return;
+  }
+  out << '"';
+  for (char c : text)
+    out << (c == '"' ? std::string_view("\"\"") : std::string_view(&c, 1));
+  out << '"';
+}
+
+void writeCsv(const AllocationReport& report, Buffer& out) {
+  // Jedna tabela dla wszystkich rekordów; puste pola oznaczają brak wartości.
+  // value: pozycja w kolejności szeregowania albo sumy (total_*).
+  out << "kind,task,unpredicted,type,instance,start,end,value\n";
+  int position = 0;
+  for (const auto& record : report.records) {
+    out << kindName(record.kind) << ',' << record.taskID << ','
+        << (int)record.unpredicted << ',';
+    if (record.procID != -1)
+      writeCsvField(out, report.typeLabels[record.procID]);
+    out << ',';
+    if (record.instance != -1)
+      out << record.instance;
+    out << ',';
+    if (record.startTime != -1) {
+      out.number(record.startTime, 0);
+      out << ',';
+      out.number(record.endTime, 0);
+    } else {
+      out << ',';
+    }
+    out << ',';
+    if (record.kind == RECORD_SCHEDULED)
+      out << position++;
+    out << '\n';
+  }
+  if (report.hasTotals) {
+    out << "total_time,,,,,,,";
+    out.number(report.overallTime, 0);
+    out << "\ntotal_cost,,,,,,,";
+    out.number(report.overallCost, 0);
+    out << '\n';
+  }
+}
+
+void writeJsonNumber(Buffer& out, double value) {
+  if (std::isfinite(value))
+    out.number(value, 0);
+  else
+    out << "null";
+}
+
+void writeJsonString(Buffer& out, const std::string& text) {
+  out << '"';
+  for (char c : text) {
+    if (c == '"' || c == '\\')
+      out << '\\';
+    out << c;
+  }
+  out << '"';
+}
+
+void writeJsonLines(const AllocationReport& report, Buffer& out) {
+  int position = 0;
+  for (const auto& record : report.records) {
+    out << "{\"kind\":\"" << kindName(record.kind) << '"';
+    if (record.kind == RECORD_SCHEDULED)
+      out << ",\"position\":" << position++;
+    out << ",\"task\":" << record.taskID << ",\"unpredicted\":"
+        << (record.unpredicted ? "true" : "false");
+    if (record.procID != -1) {
+      out << ",\"type\":";
+      writeJsonString(out, report.typeLabels[record.procID]);
+    }
+    if (record.instance != -1)
+      out << ",\"instance\":" << record.instance;
+    if (record.startTime != -1) {
+      out << ",\"start\":";
+      writeJsonNumber(out, record.startTime);
+      out << ",\"end\":";
+      writeJsonNumber(out, record.endTime);
+    }
+    out << "}\n";
+  }
+  if (report.hasTotals) {
+    out << "{\"kind\":\"total\",\"time\":";
+    writeJsonNumber(out, report.overallTime);
+    out << ",\"cost\":";
+    writeJsonNumber(out, report.overallCost);
+    out << "}\n";
+  }
+}
+
+void writeRecord(const ReportRecord& record, Buffer& out) {
+  // Układ rekordu: taskID (int32, bajt 0), procID (4), instance (8), kind
+  // (12), unpredicted (13), dwa bajty zerowe (14), startTime (double, 16),
+  // endTime (24)
+  char bytes[32] = {};
+  std::memcpy(bytes, &record.taskID, 4);
+  std::memcpy(bytes + 4, &record.procID, 4);
+  std::memcpy(bytes + 8, &record.instance, 4);
+  bytes[12] = record.kind;
+  bytes[13] = record.unpredicted;
+  std::memcpy(bytes + 16, &record.startTime, 8);
+  std::memcpy(bytes + 24, &record.endTime, 8);
+  out.bytes(bytes, sizeof bytes);
+}
+
+void writeBinary(const AllocationReport& report, Buffer& out) {
+  std::string labels{};
+  for (const auto& label : report.typeLabels)
+    labels.append(label.c_str(), label.size() + 1);
+  ReportHeader header{};
+  std::memcpy(header.magic, reportMagic, sizeof(header.magic));
+  header.version = reportVersion;
+  header.mode = report.mode;
+  header.nTypes = report.typeLabels.size();
+  header.nRecords = report.records.size();
+  header.labelsLength = labels.size();
+  header.hasTotals = report.hasTotals;
+  header.overallTime = report.overallTime;
+  header.overallCost = report.overallCost;
+  out.bytes(&header, sizeof header);
+  out.bytes(labels.data(), labels.size());
+  for (const auto& record : report.records)
+    writeRecord(record, out);
+}
+
+}
+
+bool parseReportFormat(const std::string& name, ReportFormat& format) {
+  if (name == "text")
+    format = ReportFormat::Text;
+  else if (name == "csv")
+    format = ReportFormat::Csv;
+  else if (name == "jsonl")
+    format = ReportFormat::JsonLines;
+  else if (name == "bin")
+    format = ReportFormat::Binary;
+  else
+    return false;
+  return true;
+}
+
+void writeReport(const AllocationReport& report, ReportFormat format,
+                 std::ostream& out) {
+  std::string data{};
+  data.reserve(64 + report.records.size() * 64);
+  Buffer buffer(data);
+  switch (format) {
+    case ReportFormat::Text: writeText(report, true, buffer); break;
+    case ReportFormat::PlainText: writeText(report, false, buffer); break;
+    case ReportFormat::Csv: writeCsv(report, buffer); break;
+    case ReportFormat::JsonLines: writeJsonLines(report, buffer); break;
+    case ReportFormat::Binary: writeBinary(report, buffer); break;
+  }
+  out.write(data.data(), data.size());
+  out.flush();
+}
@@ -0,0 +1,61 @@
+#ifndef ALLOCATION_REPORT_H
+#define ALLOCATION_REPORT_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Wyniki przydziału i szeregowania zbierane w pamięci. ResourceAllocator
+// tylko dopisuje rekordy (bez formatowania), a całość jest formatowana i
+// zapisywana jednym wywołaniem writeReport - tekstowo (z kolorami lub bez)
+// albo w postaci do dalszego przetwarzania (CSV, JSON Lines, binarnie).
+enum RecordKind : char {
+  RECORD_ALLOCATED,  // zadanie -> jednostka i przedział (algorytm
+                     // konstrukcyjny, HEFT)
+  RECORD_TYPE,       // zadanie -> typ zasobu (allocateMinTime i zadania
+                     // nieprzewidziane)
+  RECORD_RECOMPUTED, // przedział po recomputeAllPathsTime
+  RECORD_SCHEDULED   // kolejne zadanie w kolejności szeregowania
+};
+
+struct ReportRecord {
+  int taskID;
+  int procID;   // typ zasobu (-1 dla RECORD_SCHEDULED)
+  int instance; // numer jednostki w obrębie typu (-1 - tylko typ)
+  RecordKind kind;
+  char unpredicted;
+  double startTime; // -1 - brak przedziału
+  double endTime;
+};
+
+struct AllocationReport {
+  int mode = 1; // 1/2/3 jak w main i --batch (nagłówki formatu tekstowego)
+  std::vector<std::string> typeLabels{}; // etykiety typów, indeks = procID
+  std::vector<ReportRecord> records{}; // w kolejności powstawania
+  bool hasTotals = false;
+  double overallTime = 0;
+  double overallCost = 0;
+
+  void setTotals(double time, double cost) {
+    hasTotals = true;
+    overallTime = time;
+    overallCost = cost;
+  }
+};
+
+enum class ReportFormat {
+  Text,      // dotychczasowy wydruk z kolorami i polskimi nagłówkami
+  PlainText, // bez kolorów, jak w wynikach --batch i serwera
+  Csv,
+  JsonLines,
+  Binary
+};
+
+// "text", "csv", "jsonl" albo "bin"; false dla nieznanej nazwy
+bool parseReportFormat(const std::string& name, ReportFormat& format);
+
+// Formatuje cały raport do jednego bufora i zapisuje go jednym write
+void writeReport(const AllocationReport& report, ReportFormat format,
+                 std::ostream& out);
+
+#endif
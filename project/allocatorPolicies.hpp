@@ -0,0 +1,80 @@
+#ifndef ALLOCATOR_POLICIES_H
+#define ALLOCATOR_POLICIES_H
+
+#include <array>
+#include <span>
+#include "utilities.hpp"
+
+// Strategie (policy) podawane jako parametry szablonu BasicResourceAllocator:
+// ocena zasobu, aktualizacja współczynników i wybór rodzica. Wywołania są
+// wiązane w czasie kompilacji, więc kompilator wstawia je w pętlę po
+// kandydatach tak samo, jak wpisany na sztywno wzór. Własny model kosztu to
+// klasa z tymi samymi metodami - może mieć stan, bo alokator przechowuje
+// obiekt strategii (i kopiuje go razem z resztą stanu). Poniżej strategie
+// domyślne, czyli dotychczasowe zachowanie (ResourceAllocator).
+
+using Coefficients = std::array<double, 3>; // x, y, z
+
+// Ocena zasobu dla zadania - wybierany jest zasób o najmniejszej wartości.
+// standardised: algorytm konstrukcyjny (findBest_std), standaryzowane koszt
+// PE p, koszt zadania c i czas t oraz bieżące współczynniki.
+// timeCost: przydział zadań nieprzewidzianych (findBest_timeCost), czas i
+// koszt zadania z tabel wejściowych.
+struct StdScoring {
+  double standardised(double p, double c, double t,
+                      const Coefficients& xyz) const {
+    return computeUsingStd(p, c, t, xyz[0], xyz[1], xyz[2]);
+  }
+  double timeCost(double time, double cost) const { return time * cost; }
+};
+
+// Postęp algorytmu konstrukcyjnego, od którego zależą nowe współczynniki
+struct AllocationProgress {
+  int nAllocatedTasks; // zadania z przydzielonym zasobem
+  int nTasks;
+  double overallTime;
+  double overallCost;
+  double t_max;
+  double c_max;
+};
+
+// Aktualizacja współczynników przed przydziałem kolejnego zadania:
+// "pęd" (masa rośnie z liczbą przydzielonych zadań, prędkość to różnica
+// względnego wykorzystania limitów czasu i kosztu) i normalizacja Softmax
+struct MomentumSoftmaxUpdate {
+  void update(Coefficients& xyz, const AllocationProgress& s) const {
+    // Liczba zadań, które mają już przydzielone zasoby
+    double n = s.nAllocatedTasks;
+    // Liczenie "masy"
+    auto m = 1 + n / s.nTasks;
+    // Liczenie wektora prędkości
+    auto v_proc_cost = s.overallCost / s.c_max - s.overallTime / s.t_max;
+    auto v_times = s.overallTime / s.t_max - s.overallCost / s.c_max;
+    // Liczenie wektora pędu
+    auto p_proc_cost = m * v_proc_cost;
+    auto p_times = m * v_times;
+    xyz = softmax(xyz[0] + p_proc_cost, xyz[1] + p_proc_cost,
+                  xyz[2] + p_times);
+  }
+};
+
+// Wybór rodzica, który wyznacza ścieżkę dla dziecka (parents nie jest
+// puste). finishTime(parentID) zwraca koniec wykonania rodzica.
+// Domyślnie: rodzic kończący się najwcześniej (przy remisie pierwszy).
+struct EarliestFinishingParent {
+  template<typename FinishTime>
+  int select(std::span<const int> parents, FinishTime&& finishTime) const {
+    int bestParentID = parents[0];
+    double minEndTime = finishTime(bestParentID);
+    for (auto parentID : parents) {
+      double endTime = finishTime(parentID);
+      if (endTime < minEndTime) {
+        bestParentID = parentID;
+        minEndTime = endTime;
+      }
+    }
+    return bestParentID;
+  }
+};
+
+#endif
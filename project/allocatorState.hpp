@@ -0,0 +1,280 @@
+#ifndef ALLOCATOR_STATE_H
+#define ALLOCATOR_STATE_H
+
+#include <algorithm>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "checkpoint.hpp"
+#include "timeline.hpp"
+
+// Stan ResourceAllocator w układzie struct-of-arrays: zamiast wektora
+// obiektów Task / PE każde pole to osobny wektor, a zadanie albo jednostkę
+// PE identyfikuje indeks (uchwyt). Pętle przydziału czytają tylko potrzebne
+// pola, kopiowanie stanu to kopiowanie kilku ciągłych tablic, a nowa
+// jednostka to dopisanie po jednym elemencie do każdej z nich (wektory
+// rosną geometrycznie, więc w trakcie przydziału alokacji prawie nie ma).
+
+// Zadania: indeks = ID zadania
+struct TaskState {
+  std::vector<int> resourceID; // 1) uchwyt jednostki przydzielonej przez
+                               // algorytm konstrukcyjny
+                               // ALBO
+                               // 2) procID wybranego zasobu przy przydziale
+                               // zadań nieprzewidzianych (-1 - brak)
+  std::vector<char> unpredicted;
+  std::vector<char> scheduled;
+  std::vector<double> pathTime; // lokalna ścieżka krytyczna (-1 - brak)
+  std::vector<double> startTime; // przedział wykonania z algorytmu
+  std::vector<double> endTime;   // konstrukcyjnego (-1 - brak)
+
+  int size() const { return resourceID.size(); }
+  int add(bool unpredicted_) {
+    resourceID.push_back(-1);
+    unpredicted.push_back(unpredicted_);
+    scheduled.push_back(false);
+    pathTime.push_back(-1);
+    startTime.push_back(-1);
+    endTime.push_back(-1);
+    return resourceID.size() - 1;
+  }
+  void save(CheckpointWriter& out) const {
+    out.write(resourceID);
+    out.write(unpredicted);
+    out.write(scheduled);
+    out.write(pathTime);
+    out.write(startTime);
+    out.write(endTime);
+  }
+  void load(CheckpointReader& in) {
+    in.read(resourceID);
+    in.read(unpredicted);
+    in.read(scheduled);
+    in.read(pathTime);
+    in.read(startTime);
+    in.read(endTime);
+  }
+  bool isValid(int nInstances) const {
+    // Sprawdzenie wczytanej migawki: pola tej samej długości, uchwyty
+    // jednostek w zakresie
+    std::size_t n = resourceID.size();
+    if (unpredicted.size() != n || scheduled.size() != n ||
+        pathTime.size() != n || startTime.size() != n || endTime.size() != n)
+      return false;
+    for (int r : resourceID)
+      if (r < -1 || r >= nInstances)
+        return false;
+    return true;
+  }
+};
+
+// Listy szyn wszystkich jednostek w jednej puli: wpisy są dopisywane na
+// koniec wspólnych tablic i łączone indeksem next, więc podpięcie szyny nie
+// alokuje osobnego wektora dla jednostki.
+class ChannelLists {
+ private:
+  std::vector<int> channel;
+  std::vector<int> next; // -1 - koniec listy
+  std::vector<int> head;
+  std::vector<int> tail;
+ public:
+  class Range {
+   private:
+    const ChannelLists* lists;
+    int first;
+   public:
+    class iterator {
+     private:
+      const ChannelLists* lists;
+      int entry;
+     public:
+      iterator(const ChannelLists* lists_, int entry_)
+          : lists{lists_}, entry{entry_} {}
+      int operator*() const { return lists->channel[entry]; }
+      iterator& operator++() {
+        entry = lists->next[entry];
+        return *this;
+      }
+      bool operator!=(const iterator& it) const { return entry != it.entry; }
+    };
+    Range(const ChannelLists* lists_, int first_)
+        : lists{lists_}, first{first_} {}
+    iterator begin() const { return iterator(lists, first); }
+    iterator end() const { return iterator(lists, -1); }
+  };
+
+  void addList() {
+    head.push_back(-1);
+    tail.push_back(-1);
+  }
+  void push(int list, int channelID) {
+    int entry = channel.size();
+    channel.push_back(channelID);
+    next.push_back(-1);
+    if (tail[list] == -1)
+      head[list] = entry;
+    else
+      next[tail[list]] = entry;
+    tail[list] = entry;
+  }
+  Range operator[](int list) const { return Range(this, head[list]); }
+
+  void save(CheckpointWriter& out) const {
+    out.write(channel);
+    out.write(next);
+    out.write(head);
+    out.write(tail);
+  }
+  void load(CheckpointReader& in) {
+    in.read(channel);
+    in.read(next);
+    in.read(head);
+    in.read(tail);
+  }
+  bool isValid(int nLists, int nChannels) const {
+    // Wpisy są tylko dopisywane, więc next wskazuje zawsze dalszy wpis -
+    // to wyklucza cykle na listach
+    int size = channel.size();
+    if ((int)next.size() != size || (int)head.size() != nLists ||
+        (int)tail.size() != nLists)
+      return false;
+    for (int e = 0; e < size; ++e)
+      if (channel[e] < 0 || channel[e] >= nChannels ||
+          (next[e] != -1 && (next[e] <= e || next[e] >= size)))
+        return false;
+    for (int list = 0; list < nLists; ++list)
+      if (head[list] < -1 || head[list] >= size || tail[list] < -1 ||
+          tail[list] >= size || (head[list] == -1) != (tail[list] == -1))
+        return false;
+    return true;
+  }
+};
+
+// Zaalokowane jednostki PE: indeks = uchwyt jednostki (kolejność tworzenia).
+// Etykieta (np. HC1_0) nie jest przechowywana - to etykieta typu i numer
+// jednostki w obrębie typu, składane dopiero przy wypisywaniu (Label).
+struct InstanceState {
+  std::vector<int> procID;
+  std::vector<int> number; // numer jednostki danego typu
+  std::vector<int> totalNumOfJobs; // dotychczasowa liczba zadań
+  std::vector<double> lastTaskStartTime; // kiedy zaczęło się i skończyło
+  std::vector<double> lastTaskEndTime;   // ostatnie zadanie
+  std::vector<double> channelsCost; // suma kosztów szyn z channelIDs
+  std::vector<Timeline> timeline; // wolne przerwy (tylko przy wypełnianiu luk)
+  ChannelLists channelIDs;
+
+  int size() const { return procID.size(); }
+  int add(int procID_, int number_) {
+    procID.push_back(procID_);
+    number.push_back(number_);
+    totalNumOfJobs.push_back(0);
+    lastTaskStartTime.push_back(-1);
+    lastTaskEndTime.push_back(-1);
+    channelsCost.push_back(0);
+    timeline.emplace_back();
+    channelIDs.addList();
+    return procID.size() - 1;
+  }
+  void save(CheckpointWriter& out) const {
+    out.write(procID);
+    out.write(number);
+    out.write(totalNumOfJobs);
+    out.write(lastTaskStartTime);
+    out.write(lastTaskEndTime);
+    out.write(channelsCost);
+    for (const auto& t : timeline)
+      t.save(out);
+    channelIDs.save(out);
+  }
+  void load(CheckpointReader& in) {
+    in.read(procID);
+    in.read(number);
+    in.read(totalNumOfJobs);
+    in.read(lastTaskStartTime);
+    in.read(lastTaskEndTime);
+    in.read(channelsCost);
+    timeline.assign(in.good() ? procID.size() : 0, Timeline());
+    for (auto& t : timeline)
+      t.load(in);
+    channelIDs.load(in);
+  }
+  bool isValid(int nPEs, int nChannels) const {
+    // Sprawdzenie wczytanej migawki: pola tej samej długości, typy PE i
+    // szyny w zakresie, poprawne osie czasu
+    std::size_t n = procID.size();
+    if (number.size() != n || totalNumOfJobs.size() != n ||
+        lastTaskStartTime.size() != n || lastTaskEndTime.size() != n ||
+        channelsCost.size() != n || timeline.size() != n)
+      return false;
+    for (int p : procID)
+      if (p < 0 || p >= nPEs)
+        return false;
+    for (const auto& t : timeline)
+      if (!t.isValid())
+        return false;
+    return channelIDs.isValid(n, nChannels);
+  }
+};
+
+// Końce ostatnich zadań jednostek jednego typu PE (w kolejności tworzenia
+// jednostek) w drzewie przedziałowym minimów. Ostatnią jednostkę, której
+// ostatnie zadanie kończy się przed zadaną chwilą, znajdujemy w O(log n)
+// zamiast przeglądać wszystkie jednostki typu.
+class EndTimeIndex {
+ private:
+  std::vector<double> tree; // węzeł 1 - korzeń, liście od capacity
+  int capacity = 0; // potęga dwójki
+  int count = 0;
+
+  static constexpr double infinity = std::numeric_limits<double>::infinity();
+
+  void grow() {
+    int newCapacity = capacity == 0 ? 1 : 2 * capacity;
+    std::vector<double> grown(2 * newCapacity, infinity);
+    for (int i = 0; i < count; ++i)
+      grown[newCapacity + i] = tree[capacity + i];
+    for (int n = newCapacity - 1; n > 0; --n)
+      grown[n] = std::min(grown[2 * n], grown[2 * n + 1]);
+    tree.swap(grown);
+    capacity = newCapacity;
+  }
+ public:
+  void push(double endTime) {
+    if (count == capacity)
+      grow();
+    set(count++, endTime);
+  }
+  void set(int position, double endTime) {
+    int n = capacity + position;
+    tree[n] = endTime;
+    for (n /= 2; n > 0; n /= 2)
+      tree[n] = std::min(tree[2 * n], tree[2 * n + 1]);
+  }
+  int lastBefore(double time, bool inclusive) const {
+    // Największa pozycja z końcem < time (<= time przy inclusive), -1 jeśli
+    // nie ma takiej
+    auto fits = [time, inclusive](double end) {
+      return end < time || (inclusive && end <= time);
+    };
+    if (count == 0 || !fits(tree[1]))
+      return -1;
+    int n = 1;
+    while (n < capacity)
+      n = fits(tree[2 * n + 1]) ? 2 * n + 1 : 2 * n;
+    return n - capacity;
+  }
+};
+
+// Etykieta jednostki do wypisania: typ (np. "HC1") i numer, bez składania
+// tymczasowego napisu
+struct Label {
+  const std::string& type;
+  int number;
+};
+
+inline std::ostream& operator<<(std::ostream& os, const Label& label) {
+  return os << label.type << '_' << label.number;
+}
+
+#endif
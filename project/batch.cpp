@@ -0,0 +1,110 @@
+#include "batch.hpp"
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include "allocationReport.hpp"
+#include "loader.hpp"
+#include "threadPool.hpp"
+
+bool parseManifest(const std::string& manifestPath,
+                   std::vector<BatchJob>& jobs) {
+  std::ifstream manifest(manifestPath);
+  if (!manifest.is_open()) {
+    std::cout << "The manifest file cannot be opened.\n";
+    return false;
+  }
+  int lineNumber = 0;
+  for (std::string line; std::getline(manifest, line);) {
+    ++lineNumber;
+    std::istringstream fields(line);
+    BatchJob job{};
+    if (!(fields >> job.filepath) || job.filepath[0] == '#')
+      continue;
+    std::string rest;
+    if (!(fields >> job.t_max >> job.c_max >> job.mode) || fields >> rest ||
+        job.mode < 1 || job.mode > 3) {
+      std::cout << manifestPath << ":" << lineNumber
+                << ": expected [data] [max time] [max cost] [1/2/3]\n";
+      return false;
+    }
+    jobs.push_back(job);
+  }
+  return true;
+}
+
+std::string runJob(ResourceAllocator& r, int mode) {
+  AllocationReport report{};
+  report.mode = mode;
+  std::ostream discard(nullptr);
+  r.setOutput(&report, discard);
+  if (mode == 1 || mode == 3) {
+    if (mode == 1)
+      r.allocateAll();
+    else
+      r.allocateUpwardRank();
+    report.setTotals(r.getOverallTime(), r.getOverallCost());
+  } else {
+    r.allocateMinTime();
+    r.scheduleAllTasks();
+  }
+  std::ostringstream result;
+  writeReport(report, ReportFormat::PlainText, result);
+  return result.str();
+}
+
+int runBatch(const std::string& manifestPath, const std::string& outputPath,
+             int nThreads) {
+  std::vector<BatchJob> jobs{};
+  if (!parseManifest(manifestPath, jobs))
+    return -1;
+  std::ofstream output(outputPath);
+  if (!output.is_open()) {
+    std::cout << "The output file cannot be opened.\n";
+    return -1;
+  }
+
+  ThreadPool pool(nThreads);
+  // Ograniczamy liczbę wczytanych, a jeszcze niezapisanych zleceń, żeby
+  // przy długim manifeście nie trzymać w pamięci wszystkich grafów naraz
+  const int maxInFlight = 2 * pool.size();
+  std::deque<std::future<std::string>> pending{};
+  int written = 0;
+  auto writeNext = [&] {
+    const auto& job = jobs[written];
+    output << "@job " << written << ' ' << job.filepath << ' ' << job.t_max
+           << ' ' << job.c_max << ' ' << job.mode << '\n'
+           << pending.front().get() << '\n';
+    output.flush();
+    pending.pop_front();
+    ++written;
+  };
+
+  for (const auto& job : jobs) {
+    auto allocator =
+      loadResourceAllocator(job.filepath, job.t_max, job.c_max, false);
+    if (!allocator) {
+      std::promise<std::string> failed;
+      failed.set_value("error: the input file cannot be loaded\n");
+      pending.push_back(failed.get_future());
+    } else {
+      pending.push_back(pool.submit(
+        [allocator = std::move(allocator), mode = job.mode] {
+          // Błąd jednego zlecenia (np. cykl w grafie) to rekord "error:",
+          // a nie przerwanie całego przetwarzania
+          try {
+            return runJob(*allocator, mode);
+          } catch (const std::exception& e) {
+            return "error: " + std::string(e.what()) + "\n";
+          }
+        }));
+    }
+    while ((int)pending.size() > maxInFlight)
+      writeNext();
+  }
+  while (!pending.empty())
+    writeNext();
+  return 0;
+}
@@ -0,0 +1,38 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <string>
+#include <vector>
+#include "resourceAllocator.hpp"
+
+// Jedno zlecenie z manifestu: plik specyfikacji (tekstowej albo .tgb),
+// maksymalny czas, maksymalny koszt i tryb (1 - algorytm konstrukcyjny,
+// 2 - przydział zadań nieprzewidzianych), tak jak argumenty programu.
+struct BatchJob {
+  std::string filepath;
+  double t_max;
+  double c_max;
+  int mode;
+};
+
+// Manifest: jedna linia na zlecenie "[plik] [max time] [max cost] [1/2/3]".
+// Puste linie i linie zaczynające się od '#' są pomijane. Zwraca false
+// (po wypisaniu komunikatu z numerem linii), jeśli manifest jest błędny.
+bool parseManifest(const std::string& manifestPath,
+                   std::vector<BatchJob>& jobs);
+
+// Wykonuje zlecenie na gotowym alokatorze i zwraca wynik w tej samej
+// postaci, w jakiej wypisuje go main (bez kolorów i komunikatów
+// diagnostycznych): przydział i sumy dla trybu 1, przydział i kolejność
+// zadań dla trybu 2.
+std::string runJob(ResourceAllocator& r, int mode);
+
+// Tryb wsadowy: pliki z manifestu są wczytywane po kolei w bieżącym wątku,
+// a przydział (osobny ResourceAllocator dla każdego zlecenia) wykonuje pula
+// nThreads wątków - wczytywanie kolejnego pliku odbywa się równolegle
+// z przydziałem poprzednich. Wyniki trafiają do jednego pliku w kolejności
+// manifestu, zaraz gdy kolejne zlecenie jest gotowe.
+int runBatch(const std::string& manifestPath, const std::string& outputPath,
+             int nThreads);
+
+#endif
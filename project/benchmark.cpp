@@ -0,0 +1,274 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <filesystem>
+#include <functional>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "generator.hpp"
+#include "parser.hpp"
+#include "resourceAllocator.hpp"
+
+// Benchmark skalowania: dla kolejnych rozmiarów grafu generuje specyfikację
+// i mierzy osobno Parser::read, konstruktor ResourceAllocator, algorytm
+// konstrukcyjny (allocate dla wszystkich zadań) oraz przydział zadań
+// nieprzewidzianych (allocateMinTime + scheduleAllTasks), a także średni czas
+// wstawienia jednego zadania nieprzewidzianego w trakcie działania
+// (insertUnpredictedTask, bez pełnego przeliczania ścieżek krytycznych) -
+// wraz z kontrolą, że wyniki wstawień do kopii alokatora zgadzają się z
+// pełnym przeliczeniem.
+// Wyniki trafiają do pliku CSV. Etap, którego przewidywany czas (ekstrapolacja z dwóch
+// poprzednich rozmiarów) przekracza limit, jest pomijany (puste pole).
+// Wyjście alokatora jest domyślnie wyłączone; podanie pliku (np. /dev/null)
+// kieruje do niego wyniki i komunikaty diagnostyczne, co pozwala porównać
+// koszt logowania z wersją skompilowaną z -DLOG_LEVEL=LOG_NONE.
+// Faza allocate_virtual to ten sam algorytm konstrukcyjny ze strategiami
+// (allocatorPolicies.hpp) wywoływanymi przez interfejs z metodami
+// wirtualnymi - punkt odniesienia dla strategii jako parametrów szablonu.
+
+namespace {
+
+const int nPhases = 6;
+const char* phaseNames[nPhases] = {"parse", "construct", "allocate",
+                                   "schedule", "insert", "allocate_virtual"};
+const int nInserted = 100; // zadania wstawiane przy pomiarze fazy insert
+
+// Strategie domyślne za interfejsem wirtualnym (wyniki są takie same)
+struct PolicyInterface {
+  virtual ~PolicyInterface() {}
+  virtual double standardised(double p, double c, double t,
+                              const Coefficients& xyz) const = 0;
+  virtual double timeCost(double time, double cost) const = 0;
+  virtual void update(Coefficients& xyz,
+                      const AllocationProgress& s) const = 0;
+  virtual int select(std::span<const int> parents,
+                     const std::function<double(int)>& finishTime) const = 0;
+};
+
+struct DefaultPolicies : PolicyInterface {
+  double standardised(double p, double c, double t,
+                      const Coefficients& xyz) const override {
+    return StdScoring{}.standardised(p, c, t, xyz);
+  }
+  double timeCost(double time, double cost) const override {
+    return StdScoring{}.timeCost(time, cost);
+  }
+  void update(Coefficients& xyz, const AllocationProgress& s) const override {
+    MomentumSoftmaxUpdate{}.update(xyz, s);
+  }
+  int select(std::span<const int> parents,
+             const std::function<double(int)>& finishTime) const override {
+    return EarliestFinishingParent{}.select(parents, finishTime);
+  }
+};
+
+struct VirtualPolicy {
+  const PolicyInterface* policies; // ustawiane w czasie działania
+  double standardised(double p, double c, double t,
+                      const Coefficients& xyz) const {
+    return policies->standardised(p, c, t, xyz);
+  }
+  double timeCost(double time, double cost) const {
+    return policies->timeCost(time, cost);
+  }
+  void update(Coefficients& xyz, const AllocationProgress& s) const {
+    policies->update(xyz, s);
+  }
+  int select(std::span<const int> parents,
+             const std::function<double(int)>& finishTime) const {
+    return policies->select(parents, finishTime);
+  }
+};
+
+using VirtualResourceAllocator =
+  BasicResourceAllocator<VirtualPolicy, VirtualPolicy, VirtualPolicy>;
+
+double seconds(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(
+    std::chrono::steady_clock::now() - start).count();
+}
+
+struct PhaseHistory {
+  std::vector<std::pair<double, double>> points{}; // (nTasks, seconds)
+  bool shouldSkip(double nTasks, double limit) const {
+    if (points.empty())
+      return false;
+    auto [n1, s1] = points.back();
+    double exponent = 2; // ostrożnie: zakładamy złożoność kwadratową
+    if (points.size() > 1) {
+      auto [n0, s0] = points[points.size() - 2];
+      if (s0 > 1e-3 && s1 > 1e-3)
+        exponent = std::max(1.0, std::log(s1 / s0) / std::log(n1 / n0));
+    }
+    return s1 * std::pow(nTasks / n1, exponent) > limit;
+  }
+};
+
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    std::cout << "\nRun the benchmark as the following:\n\n"
+      << "  $ ./benchmark [output.csv] [sizes] [limit] [fan-out] [log file]\n"
+      << "\n  sizes: comma separated task counts "
+      << "(default 1000,10000,100000,1000000);\n"
+      << "  limit: skip a phase when its predicted time exceeds this many "
+      << "seconds (default 60);\n"
+      << "  log file: where the allocator trace goes, e.g. /dev/null "
+      << "(default: discarded).\n\n";
+    return 0;
+  }
+#ifndef NDEBUG
+  std::cout << "Warning: built without -DNDEBUG, allocate() cross-checks "
+            << "its totals after every task.\n";
+#endif
+  std::vector<int> sizes{1000, 10000, 100000, 1000000};
+  if (argc > 2) {
+    sizes.clear();
+    std::stringstream list(argv[2]);
+    for (std::string item; std::getline(list, item, ',');)
+      sizes.push_back(std::stoi(item));
+  }
+  double limit = argc > 3 ? std::stod(std::string(argv[3])) : 60;
+  GeneratorOptions options{};
+  options.unpredictedRatio = 0.1;
+  if (argc > 4)
+    options.fanOut = std::stod(std::string(argv[4]));
+
+  std::ofstream csv(argv[1]);
+  if (!csv.is_open()) {
+    std::cout << "The output file cannot be opened.\n";
+    return 1;
+  }
+  csv << "tasks,edges,fan_out,pe_types,channels,"
+      << "parse_s,construct_s,allocate_s,schedule_s,insert_s,"
+      << "allocate_virtual_s\n";
+  auto specPath = (std::filesystem::temp_directory_path() /
+                   "benchmark_spec.txt").string();
+  PhaseHistory history[nPhases];
+  std::mt19937 rng(1);
+  std::ostream discard(nullptr);
+  std::ofstream logFile{};
+  if (argc > 5)
+    logFile.open(argv[5]);
+  std::ostream& log = logFile.is_open() ? logFile : discard;
+
+  for (auto n : sizes) {
+    options.nTasks = n;
+    long nEdges = generateSpecification(options, specPath);
+    if (nEdges == -1) {
+      std::cout << "Cannot write " << specPath << '\n';
+      return 1;
+    }
+    double times[nPhases] = {-1, -1, -1, -1, -1, -1};
+
+    auto start = std::chrono::steady_clock::now();
+    Parser p{};
+    if (p.read(specPath) == -1)
+      return 1;
+    times[0] = seconds(start);
+
+    int nPE = p.getProcMatrix().d1;
+    // Kopia tabel dla alokatora ze strategiami wirtualnymi (przed
+    // przeniesieniem ich do r, poza pomiarem)
+    VirtualResourceAllocator virtualAllocator{p.getTaskGraph(),
+      p.getProcMatrix(), p.getTimesMatrix(), p.getCostMatrix(),
+      p.getCommMatrix(), p.getUnpredictedTasksMask(), 1e4 * n, 1e6 * n};
+    start = std::chrono::steady_clock::now();
+    ResourceAllocator r{std::move(p.getTaskGraph()),
+                        std::move(p.getProcMatrix()),
+                        std::move(p.getTimesMatrix()),
+                        std::move(p.getCostMatrix()),
+                        p.getCommMatrix(), p.getUnpredictedTasksMask(),
+                        1e4 * n, 1e6 * n};
+    times[1] = seconds(start);
+    r.setOutput(nullptr, log);
+    ResourceAllocator unpredicted{r};
+
+    if (!history[2].shouldSkip(n, limit)) {
+      start = std::chrono::steady_clock::now();
+      r.allocateAll();
+      times[2] = seconds(start);
+    }
+    if (!history[3].shouldSkip(n, limit)) {
+      start = std::chrono::steady_clock::now();
+      unpredicted.allocateMinTime();
+      unpredicted.scheduleAllTasks();
+      times[3] = seconds(start);
+    }
+    if (times[3] >= 0) {
+      // Stan jak w trakcie szeregowania: ścieżki policzone, nic jeszcze nie
+      // poszeregowane. Czas w CSV to średnia na jedno wstawienie.
+      ResourceAllocator online{r};
+      online.allocateMinTime();
+      online.computeCriticalPaths();
+      std::vector<double> taskTimes(nPE), taskCosts(nPE);
+      std::vector<std::pair<int, double>> parents(2), children{};
+      auto insertRandomTask = [&] {
+        for (int i = 0; i < nPE; ++i) {
+          taskTimes[i] = 1 + rng() % 300;
+          taskCosts[i] = 1 + rng() % 100;
+        }
+        for (auto& [parentID, data] : parents) {
+          parentID = rng() % n;
+          data = rng() % 50;
+        }
+        online.insertUnpredictedTask(taskTimes, taskCosts, parents, children);
+      };
+      // Pierwsze wstawienie do kopii kopiuje współdzielony graf i tabele
+      // (copy-on-write) - jednorazowo, więc poza pomiarem
+      insertRandomTask();
+      start = std::chrono::steady_clock::now();
+      for (int k = 0; k < nInserted; ++k)
+        insertRandomTask();
+      times[4] = seconds(start) / nInserted;
+      // Kontrola (poza pomiarem): online to kopia r, więc pierwsze wstawienie
+      // kopiuje współdzielony graf. Ścieżki po wstawieniach muszą być takie
+      // jak po pełnym przeliczeniu, a r nie może zobaczyć nowych zadań.
+      ResourceAllocator rebuilt{online};
+      rebuilt.computeCriticalPaths();
+      bool consistent = r.getNumberOfTasks() == n;
+      for (int t = 0; t < online.getNumberOfTasks(); ++t)
+        if (online.getBottomLevel(t) != rebuilt.getBottomLevel(t))
+          consistent = false;
+      if (!consistent)
+        std::cout << "Warning: inserting into a copied allocator gave wrong"
+                  << " critical paths.\n";
+    }
+    if (times[2] >= 0 && !history[5].shouldSkip(n, limit)) {
+      DefaultPolicies policies{};
+      virtualAllocator.getScoring().policies = &policies;
+      virtualAllocator.getCoefficientUpdate().policies = &policies;
+      virtualAllocator.getParentSelection().policies = &policies;
+      virtualAllocator.setOutput(nullptr, log);
+      start = std::chrono::steady_clock::now();
+      virtualAllocator.allocateAll();
+      times[5] = seconds(start);
+      if (virtualAllocator.getOverallTime() != r.getOverallTime() ||
+          virtualAllocator.getOverallCost() != r.getOverallCost())
+        std::cout << "Warning: virtual policies changed the result.\n";
+    }
+
+    csv << n << ',' << nEdges << ',' << options.fanOut << ',' << options.nPE
+        << ',' << options.nChannels;
+    std::cout << n << " tasks, " << nEdges << " edges:";
+    for (int i = 0; i < nPhases; ++i) {
+      csv << ',';
+      if (times[i] >= 0) {
+        history[i].points.push_back({(double)n, times[i]});
+        csv << times[i];
+        std::cout << ' ' << phaseNames[i] << ' ' << times[i] << " s";
+      } else {
+        std::cout << ' ' << phaseNames[i] << " skipped";
+      }
+    }
+    csv << '\n';
+    std::cout << '\n';
+  }
+  std::remove(specPath.c_str());
+  return 0;
+}
@@ -0,0 +1,172 @@
+#ifndef CHANNEL_INDEX_H
+#define CHANNEL_INDEX_H
+
+#include <cstdint>
+#include <vector>
+#include "utilities.hpp"
+
+// Zbiór numerów szyn jako bitset o rozmiarze ustalonym przy tworzeniu.
+class ChannelBitset {
+ private:
+  std::vector<std::uint64_t> words;
+ public:
+  ChannelBitset() : words{} {}
+  explicit ChannelBitset(int n) : words((n + 63) / 64) {}
+  void set(int i) { words[i >> 6] |= std::uint64_t(1) << (i & 63); }
+  bool test(int i) const { return words[i >> 6] >> (i & 63) & 1; }
+  bool intersects(const ChannelBitset& b) const {
+    for (int w = 0; w < (int)words.size(); ++w)
+      if (words[w] & b.words[w])
+        return true;
+    return false;
+  }
+};
+
+// Indeks łączności szyn budowany raz w konstruktorze ResourceAllocator:
+// bitset szyn dla każdego typu PE oraz tablice gotowych odpowiedzi dla
+// findBestChannel. Reguły wyboru są takie same jak w dawnym przeglądaniu
+// wektora szyn: kandydatem startowym jest ostatnia pasująca szyna, a
+// wygrywa pierwsza szyna o ściśle mniejszym koszcie (czyli pierwsze
+// wystąpienie minimum, chyba że minimum ma już ostatnia pasująca szyna).
+class ChannelIndex {
+ private:
+  int nPEs;
+  int nChannels;
+  std::vector<ChannelBitset> channelsOfPE; // szyny podłączone do typu PE
+  std::vector<int> rootChannels;           // szyna dla zadań bez rodzica
+  std::vector<int> sharedChannels;         // [p * nPEs + q], -1 gdy brak
+  std::vector<int> firstSharedChannels;    // [p * nPEs + q], -1 gdy brak
+  std::vector<int> fastestChannels;        // [p * nPEs + q], -1 gdy brak
+ public:
+  ChannelIndex() : nPEs{0}, nChannels{0} {}
+
+  void build(const std::vector<Channel>& channels, int nPEs_) {
+    nPEs = nPEs_;
+    nChannels = channels.size();
+    channelsOfPE.assign(nPEs, ChannelBitset(nChannels));
+    for (auto& channel : channels)
+      for (int p = 0; p < nPEs; ++p)
+        if (channel.connections[p])
+          channelsOfPE[p].set(channel.id);
+
+    int cheapest = -1; // pierwsza najtańsza szyna w ogóle
+    for (auto& channel : channels)
+      if (cheapest == -1 || channel.cost < channels[cheapest].cost)
+        cheapest = channel.id;
+    rootChannels.assign(nPEs, cheapest);
+    for (int p = 0; p < nPEs; ++p) {
+      int last = -1;
+      for (auto& channel : channels)
+        if (channel.connections[p])
+          last = channel.id;
+      if (last != -1 && channels[last].cost <= channels[cheapest].cost)
+        rootChannels[p] = last;
+    }
+
+    sharedChannels.assign(nPEs * nPEs, -1);
+    firstSharedChannels.assign(nPEs * nPEs, -1);
+    fastestChannels.assign(nPEs * nPEs, -1);
+    for (int p = 0; p < nPEs; ++p)
+      for (int q = 0; q < nPEs; ++q) {
+        int first = -1;
+        int last = -1;
+        int fastest = -1; // największa przepustowość, potem mniejszy koszt
+        for (auto& channel : channels)
+          if (channel.connections[p] && channel.connections[q]) {
+            if (first == -1)
+              first = channel.id;
+            last = channel.id;
+            if (fastest == -1 ||
+                channel.bandwidth > channels[fastest].bandwidth ||
+                (channel.bandwidth == channels[fastest].bandwidth &&
+                 channel.cost < channels[fastest].cost))
+              fastest = channel.id;
+          }
+        firstSharedChannels[p * nPEs + q] = first;
+        fastestChannels[p * nPEs + q] = fastest;
+        if (last == -1)
+          continue;
+        int choice = last;
+        double minCost = channels[last].cost;
+        for (auto& channel : channels)
+          if (channel.connections[p] && channel.connections[q] &&
+              channel.cost < minCost) {
+            minCost = channel.cost;
+            choice = channel.id;
+          }
+        sharedChannels[p * nPEs + q] = choice;
+      }
+  }
+
+  int getNumberOfChannels() const { return nChannels; }
+  int getNumberOfPEs() const { return nPEs; }
+  const ChannelBitset& channelsOf(int procID) const {
+    return channelsOfPE[procID];
+  }
+  bool connects(int channelID, int procID) const {
+    return channelsOfPE[procID].test(channelID);
+  }
+  int rootChannel(int procID) const { return rootChannels[procID]; }
+  int sharedChannel(int p, int q) const { return sharedChannels[p * nPEs + q]; }
+  int firstSharedChannel(int p, int q) const {
+    return firstSharedChannels[p * nPEs + q];
+  }
+  int fastestChannel(int p, int q) const {
+    return fastestChannels[p * nPEs + q];
+  }
+};
+
+// Szyny podpięte do zaalokowanych instancji PE: bitset przynależności
+// oraz, dla każdego typu PE, odpowiedź na pytanie "którą z moich szyn
+// połączyć się z tym typem" aktualizowana przy każdym podpięciu. Wiersze
+// wszystkich instancji (wiersz = uchwyt instancji) leżą w tych samych
+// tablicach, więc nowa instancja nie alokuje własnych wektorów.
+class InstanceChannelTable {
+ private:
+  int nPEs;
+  int nWords;
+  std::vector<std::uint64_t> members; // [r * nWords + w]
+  std::vector<int> firstCheapest;     // [r * nPEs + p], pierwsze minimum
+  std::vector<int> lastAdded;         // [r * nPEs + p], ostatnio podpięta
+  std::vector<double> cheapestCost;   // [r * nPEs + p]
+ public:
+  InstanceChannelTable() : nPEs{0}, nWords{0} {}
+  void build(const ChannelIndex& index) {
+    nPEs = index.getNumberOfPEs();
+    nWords = (index.getNumberOfChannels() + 63) / 64;
+  }
+  void addInstance() {
+    members.resize(members.size() + nWords, 0);
+    firstCheapest.resize(firstCheapest.size() + nPEs, -1);
+    lastAdded.resize(lastAdded.size() + nPEs, -1);
+    cheapestCost.resize(cheapestCost.size() + nPEs, 0);
+  }
+
+  void add(int r, int channelID, double cost, const ChannelIndex& index) {
+    members[r * nWords + (channelID >> 6)] |=
+      std::uint64_t(1) << (channelID & 63);
+    for (int p = 0; p < nPEs; ++p)
+      if (index.connects(channelID, p)) {
+        int k = r * nPEs + p;
+        if (lastAdded[k] == -1 || cost < cheapestCost[k]) {
+          cheapestCost[k] = cost;
+          firstCheapest[k] = channelID;
+        }
+        lastAdded[k] = channelID;
+      }
+  }
+  bool contains(int r, int channelID) const {
+    return members[r * nWords + (channelID >> 6)] >> (channelID & 63) & 1;
+  }
+  int bestChannelTo(int r, int procID,
+                    const std::vector<Channel>& channels) const {
+    // -1 jeśli żadna z szyn instancji nie sięga typu procID
+    int k = r * nPEs + procID;
+    int last = lastAdded[k];
+    if (last == -1)
+      return -1;
+    return channels[last].cost <= cheapestCost[k] ? last : firstCheapest[k];
+  }
+};
+
+#endif
@@ -0,0 +1,118 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Migawka stanu ResourceAllocator (plik binarny, liczby w natywnej kolejności
+// bajtów, każdy element wyrównany do 8 bajtów):
+//   CheckpointHeader
+//   sumy i liczniki (overallTime, overallCost, ich składowe,
+//   nAllocatedTasks, x_y_z, PE_instances_ids)
+//   TaskState, InstanceState (z listami szyn i osiami czasu jednostek)
+// Wektor to liczba elementów (uint64) i ich surowe bajty. Struktury
+// pochodne (indeksy jednostek wg typu, tablica szyn jednostek) nie są
+// zapisywane - odtwarza je odczyt.
+
+const char checkpointMagic[8] = {'T', 'G', 'C', 'H', 'E', 'C', 'K', '1'};
+const std::uint32_t checkpointVersion = 1;
+
+struct CheckpointHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::int32_t nTasks;
+  std::int32_t nPEs;
+  std::int32_t nChannels;
+  std::int32_t nEdges;
+  std::int32_t fillGaps;
+  std::uint64_t tablesHash; // skrót tabel proc, times i cost
+  double t_max;
+  double c_max;
+};
+
+// Nagłówek jest zapisywany bajt w bajt, więc nie może mieć bajtów
+// wyrównania (ich zawartość trafiłaby do pliku)
+static_assert(sizeof(CheckpointHeader) == 56, "no padding in CheckpointHeader");
+
+class CheckpointWriter {
+ private:
+  std::ofstream out;
+  std::size_t offset;
+ public:
+  explicit CheckpointWriter(const std::string& path)
+      : out(path, std::ios::binary | std::ios::trunc), offset{0} {}
+  bool good() const { return out.good(); }
+  void bytes(const void* data, std::size_t size) {
+    out.write(static_cast<const char*>(data), size);
+    offset += size;
+    static const char zeros[8] = {};
+    out.write(zeros, (8 - offset % 8) % 8);
+    offset += (8 - offset % 8) % 8;
+  }
+  template<typename T>
+  void write(const T& value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    bytes(&value, sizeof value);
+  }
+  template<typename T>
+  void write(const std::vector<T>& v) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    std::uint64_t count = v.size();
+    write(count);
+    bytes(v.data(), count * sizeof(T));
+  }
+};
+
+// Odczyt sprawdza, czy deklarowane rozmiary mieszczą się w pliku, więc
+// uszkodzony plik kończy się błędem (good() == false), a nie ogromną
+// alokacją
+class CheckpointReader {
+ private:
+  std::ifstream in;
+  std::uint64_t remaining;
+  bool ok;
+ public:
+  explicit CheckpointReader(const std::string& path)
+      : in(path, std::ios::binary | std::ios::ate), remaining{0},
+        ok{in.is_open()} {
+    if (ok) {
+      remaining = in.tellg();
+      in.seekg(0);
+    }
+  }
+  bool good() const { return ok; }
+  void bytes(void* data, std::size_t size) {
+    std::size_t padded = (size + 7) & ~std::size_t(7);
+    if (!ok || padded > remaining) {
+      ok = false;
+      return;
+    }
+    in.read(static_cast<char*>(data), size);
+    in.ignore(padded - size);
+    remaining -= padded;
+    ok = in.good();
+  }
+  template<typename T>
+  void read(T& value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    bytes(&value, sizeof value);
+  }
+  template<typename T>
+  void read(std::vector<T>& v) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    std::uint64_t count = 0;
+    read(count);
+    if (!ok || count > remaining / sizeof(T)) {
+      ok = false;
+      return;
+    }
+    v.resize(count);
+    bytes(v.data(), count * sizeof(T));
+  }
+  bool atEnd() const { return ok && remaining == 0; }
+};
+
+#endif
@@ -0,0 +1,282 @@
+#include "compiledGraph.hpp"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include "mappedFile.hpp"
+#include "parser.hpp"
+#include "perf.hpp"
+#include "utilities.hpp"
+
+// Układ pliku .tgb (liczby w natywnej kolejności bajtów, każda sekcja
+// wyrównana do 8 bajtów):
+//   CompiledGraphHeader
+//   bezwzględna ścieżka pliku źródłowego (sourcePathLength bajtów)
+//   maska zadań nieprzewidzianych (uint8 x nTasks)
+//   CSR następników: offsets (int32 x nTasks+1), ids (int32 x nEdges),
+//                    weights (double x nEdges)
+//   CSR poprzedników: jak wyżej
+//   proc (nPE x 3), times (nTasks x nPE), cost (nTasks x nPE),
+//   comm (nChannels x 2+nPE), procStd, timesStd, costStd - double, row-major
+
+namespace {
+
+const char compiledGraphMagic[8] = {'T', 'G', 'R', 'A', 'P', 'H', 'B', '1'};
+const std::uint32_t compiledGraphVersion = 2;
+
+struct CompiledGraphHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t sourcePathLength;
+  std::uint64_t sourceHash;
+  std::uint64_t sourceSize;  // rozmiar i czas modyfikacji źródła - skrót
+  std::int64_t sourceMtime;  // liczymy tylko, gdy któreś się zmieniło
+  std::uint64_t fileSize;
+  std::int32_t nTasks;
+  std::int32_t nPE;
+  std::int32_t nChannels;
+  std::int32_t nEdges;
+};
+
+std::size_t align8(std::size_t n) { return (n + 7) & ~std::size_t(7); }
+
+std::int64_t modificationTime(const std::string& path, std::error_code& error) {
+  return std::filesystem::last_write_time(path, error)
+    .time_since_epoch().count();
+}
+
+// Sprawdza tablice CSR z pliku: przesunięcia niemalejące od 0 do nEdges,
+// identyfikatory zadań w [0, nTasks)
+bool isValidAdjacency(const int* offsets, const int* ids, int nTasks,
+                      int nEdges) {
+  if (offsets[0] != 0 || offsets[nTasks] != nEdges)
+    return false;
+  for (int i = 0; i < nTasks; ++i)
+    if (offsets[i + 1] < offsets[i])
+      return false;
+  for (int e = 0; e < nEdges; ++e)
+    if (ids[e] < 0 || ids[e] >= nTasks)
+      return false;
+  return true;
+}
+
+class Writer {
+ private:
+  std::ofstream& out;
+  std::size_t offset;
+ public:
+  Writer(std::ofstream& out_) : out{out_}, offset{0} {}
+  void write(const void* data, std::size_t size) {
+    out.write(static_cast<const char*>(data), size);
+    offset += size;
+    static const char zeros[8] = {};
+    out.write(zeros, align8(offset) - offset);
+    offset = align8(offset);
+  }
+  template<typename T>
+  void write(const std::vector<T>& v) { write(v.data(), v.size() * sizeof(T)); }
+  void write(const Matrix<double>& m) {
+    write(m.data(), m.size() * sizeof(double));
+  }
+  std::size_t size() const { return offset; }
+};
+
+class Reader {
+ private:
+  char* pos;
+  char* end;
+ public:
+  Reader(char* begin_, char* end_) : pos{begin_}, end{end_} {}
+  template<typename T>
+  T* take(std::size_t count) {
+    // Zwraca wskaźnik na count elementów w zmapowanym pliku
+    std::size_t size = count * sizeof(T);
+    if ((std::size_t)(end - pos) < size)
+      return nullptr;
+    T* result = reinterpret_cast<T*>(pos);
+    pos += std::min(align8(size), (std::size_t)(end - pos));
+    return result;
+  }
+};
+
+}
+
+std::uint64_t hashBytes(const char* data, std::size_t size) {
+  // FNV-1a, 64 bity
+  std::uint64_t hash = 14695981039346656037ull;
+  for (std::size_t i = 0; i < size; ++i) {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+int compileTaskGraph(const std::string& sourcePath,
+                     const std::string& outputPath) {
+  MappedFile source;
+  if (!source.open(sourcePath)) {
+    std::cout << "The input file cannot be opened.\n";
+    return -1;
+  }
+  // Ścieżka bezwzględna, żeby sprawdzenie aktualności działało niezależnie
+  // od katalogu, z którego uruchomiono program
+  std::error_code error;
+  std::string absoluteSourcePath =
+    std::filesystem::absolute(sourcePath, error).string();
+  std::int64_t sourceMtime = modificationTime(sourcePath, error);
+  if (error) {
+    std::cout << "The input file cannot be opened.\n";
+    return -1;
+  }
+  Parser p{};
+  if (p.read(sourcePath) == -1)
+    return -1;
+  auto& graph = p.getTaskGraph();
+  auto& proc = p.getProcMatrix();
+  auto& times = p.getTimesMatrix();
+  auto& cost = p.getCostMatrix();
+  auto& comm = p.getCommMatrix();
+  auto& mask = p.getUnpredictedTasksMask();
+
+  CompiledGraphHeader header{};
+  std::memcpy(header.magic, compiledGraphMagic, sizeof(header.magic));
+  header.version = compiledGraphVersion;
+  header.sourcePathLength = absoluteSourcePath.size();
+  header.sourceHash = hashBytes(source.data(), source.size());
+  header.sourceSize = source.size();
+  header.sourceMtime = sourceMtime;
+  header.nTasks = graph.getNumberOfTasks();
+  header.nPE = proc.d1;
+  header.nChannels = comm.d1;
+  header.nEdges = graph.getNumberOfEdges();
+
+  std::ofstream out(outputPath, std::ios::binary | std::ios::trunc);
+  if (!out.is_open()) {
+    std::cout << "The output file cannot be opened.\n";
+    return -1;
+  }
+  Writer w(out);
+  w.write(&header, sizeof(header));
+  w.write(absoluteSourcePath.data(), absoluteSourcePath.size());
+  std::vector<std::uint8_t> maskBytes(mask.begin(), mask.end());
+  w.write(maskBytes);
+  w.write(graph.getChildOffsets());
+  w.write(graph.getChildIDs());
+  w.write(graph.getChildWeights());
+  w.write(graph.getParentOffsets());
+  w.write(graph.getParentIDs());
+  w.write(graph.getParentWeights());
+  w.write(proc);
+  w.write(times);
+  w.write(cost);
+  w.write(comm);
+  // Jeden bufor na wszystkie trzy tabele (times i cost mają te same wymiary)
+  Matrix<double> standardised{};
+  standardiseData(proc, true, standardised);
+  w.write(standardised);
+  standardiseData(times, false, standardised);
+  w.write(standardised);
+  standardiseData(cost, false, standardised);
+  w.write(standardised);
+  // Rozmiar pliku znany jest dopiero na końcu - dopisujemy go do nagłówka
+  header.fileSize = w.size();
+  out.seekp(0);
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  if (!out) {
+    std::cout << "Writing " << outputPath << " failed.\n";
+    return -1;
+  }
+  return 0;
+}
+
+bool isCompiledTaskGraph(const std::string& filepath) {
+  std::ifstream in(filepath, std::ios::binary);
+  char magic[8] = {};
+  in.read(magic, sizeof(magic));
+  return in && std::memcmp(magic, compiledGraphMagic, sizeof(magic)) == 0;
+}
+
+int loadCompiledTaskGraph(const std::string& filepath, CompiledGraph& graph) {
+  PerfTimer timer(PHASE_PARSE);
+  // Mapujemy plik w trybie copy-on-write: tabele alokatora wskazują wprost
+  // na strony pliku, a ewentualne zapisy nie trafiają na dysk.
+  auto file = std::make_shared<MappedFile>();
+  if (!file->open(filepath, true)) {
+    std::cout << "The input file cannot be opened.\n";
+    return -1;
+  }
+  char* begin = file->mutableData();
+  Reader r(begin, begin + file->size());
+  auto header = r.take<CompiledGraphHeader>(1);
+  if (!header || std::memcmp(header->magic, compiledGraphMagic, 8) != 0 ||
+      header->version != compiledGraphVersion ||
+      header->fileSize != file->size() || header->nTasks < 0 ||
+      header->nPE < 0 || header->nChannels < 0 || header->nEdges < 0) {
+    std::cout << filepath << ": not a valid compiled task graph.\n";
+    return -1;
+  }
+  int nTasks = header->nTasks;
+  int nPE = header->nPE;
+  int nChannels = header->nChannels;
+  int nEdges = header->nEdges;
+  auto sourcePath = r.take<char>(header->sourcePathLength);
+  auto mask = r.take<std::uint8_t>(nTasks);
+  auto childOffsets = r.take<int>(nTasks + 1);
+  auto childIDs = r.take<int>(nEdges);
+  auto childWeights = r.take<double>(nEdges);
+  auto parentOffsets = r.take<int>(nTasks + 1);
+  auto parentIDs = r.take<int>(nEdges);
+  auto parentWeights = r.take<double>(nEdges);
+  std::size_t sizes[7] = {(std::size_t)nPE * 3, (std::size_t)nTasks * nPE,
+    (std::size_t)nTasks * nPE, (std::size_t)nChannels * (2 + nPE),
+    (std::size_t)nPE * 3, (std::size_t)nTasks * nPE, (std::size_t)nTasks * nPE};
+  double* tables[7];
+  for (int i = 0; i < 7; ++i)
+    tables[i] = r.take<double>(sizes[i]);
+  if (!parentWeights || !tables[6]) {
+    std::cout << filepath << ": truncated compiled task graph.\n";
+    return -1;
+  }
+  if (!isValidAdjacency(childOffsets, childIDs, nTasks, nEdges) ||
+      !isValidAdjacency(parentOffsets, parentIDs, nTasks, nEdges)) {
+    std::cout << filepath << ": not a valid compiled task graph.\n";
+    return -1;
+  }
+
+  // Jeśli plik źródłowy nadal istnieje, sprawdzamy czy się nie zmienił.
+  // Niezmieniony rozmiar i czas modyfikacji wystarczą; skrót liczymy tylko
+  // wtedy, gdy któreś z nich jest inne (np. plik tylko dotknięto).
+  graph.sourcePath = std::string(sourcePath, header->sourcePathLength);
+  graph.sourceHash = header->sourceHash;
+  std::error_code error;
+  auto sourceSize = std::filesystem::file_size(graph.sourcePath, error);
+  auto sourceMtime = error ? 0 : modificationTime(graph.sourcePath, error);
+  MappedFile source;
+  if (!error &&
+      (sourceSize != header->sourceSize ||
+       sourceMtime != header->sourceMtime) &&
+      source.open(graph.sourcePath) &&
+      hashBytes(source.data(), source.size()) != graph.sourceHash) {
+    std::cout << filepath << ": " << graph.sourcePath << " has changed since "
+      << "compilation, run --compile again.\n";
+    return -1;
+  }
+
+  graph.unpredictedTasksMask.assign(mask, mask + nTasks);
+  graph.taskGraph.assign(nTasks,
+    std::span<const int>(childOffsets, nTasks + 1),
+    std::span<const int>(childIDs, nEdges),
+    std::span<const double>(childWeights, nEdges),
+    std::span<const int>(parentOffsets, nTasks + 1),
+    std::span<const int>(parentIDs, nEdges),
+    std::span<const double>(parentWeights, nEdges));
+  graph.proc = Matrix<double>::view(tables[0], nPE, 3, file);
+  graph.times = Matrix<double>::view(tables[1], nTasks, nPE, file);
+  graph.cost = Matrix<double>::view(tables[2], nTasks, nPE, file);
+  graph.comm = Matrix<double>::view(tables[3], nChannels, 2 + nPE, file);
+  graph.procStd = Matrix<double>::view(tables[4], nPE, 3, file);
+  graph.timesStd = Matrix<double>::view(tables[5], nTasks, nPE, file);
+  graph.costStd = Matrix<double>::view(tables[6], nTasks, nPE, file);
+  return 0;
+}
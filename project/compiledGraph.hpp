@@ -0,0 +1,36 @@
+#ifndef COMPILED_GRAPH_H
+#define COMPILED_GRAPH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "matrix.hpp"
+#include "taskGraph.hpp"
+
+// Skompilowana specyfikacja grafu zadań (plik .tgb). Zawiera wszystko, czego
+// potrzebuje ResourceAllocator, łącznie z już wystandaryzowanymi tabelami
+// proc, times i cost, oraz bezwzględną ścieżkę, rozmiar, czas modyfikacji i
+// skrót (FNV-1a) pliku źródłowego. Tabele wczytane przez
+// loadCompiledTaskGraph wskazują bezpośrednio na zmapowany plik.
+struct CompiledGraph {
+  std::uint64_t sourceHash = 0;
+  std::string sourcePath{};
+  TaskGraph taskGraph{};
+  Matrix<double> proc{};
+  Matrix<double> times{};
+  Matrix<double> cost{};
+  Matrix<double> comm{};
+  Matrix<double> procStd{};
+  Matrix<double> timesStd{};
+  Matrix<double> costStd{};
+  std::vector<bool> unpredictedTasksMask{};
+};
+
+std::uint64_t hashBytes(const char* data, std::size_t size);
+int compileTaskGraph(const std::string& sourcePath,
+                     const std::string& outputPath);
+bool isCompiledTaskGraph(const std::string& filepath);
+int loadCompiledTaskGraph(const std::string& filepath, CompiledGraph& graph);
+
+#endif
@@ -0,0 +1,194 @@
+#ifndef CRITICAL_PATH_H
+#define CRITICAL_PATH_H
+
+#include <queue>
+#include <stdexcept>
+#include <vector>
+#include "taskGraph.hpp"
+#include "dagTraversal.hpp"
+
+// Silnik ścieżek krytycznych dla szeregowania zadań. Dla każdego zadania
+// trzyma bottom level, czyli długość najdłuższej ścieżki od zadania do ujścia
+// grafu (łącznie z czasem wykonania samego zadania):
+//   bl(t) = czas(t) + max{ bl(c) : c jest następnikiem t }.
+// Wartości liczone są raz, w odwrotnym porządku topologicznym, a po zmianie
+// czasu zadania (albo dodaniu nowego zadania, patrz addTask) poprawiane są
+// tylko dla jego przodków. Kolejne zadanie do poszeregowania wybierane jest
+// z kolejki priorytetowej (najdłuższa ścieżka, przy remisie najmniejsze ID).
+// Silnik trzyma też najwcześniejszy możliwy start każdego zadania (top
+// level, bez czasów transmisji - tak jak bottom level):
+//   es(t) = max{ es(p) + czas(p) : p jest poprzednikiem t }, 0 dla korzeni.
+// Przy budowie z nThreads > 1 oba przejścia wykonuje traverseDag (work
+// stealing); wartości są takie same jak w przejściu sekwencyjnym, bo każda
+// z nich liczona jest tym samym wzorem z tych samych danych.
+// Silnik nie pamięta grafu - metody, które go czytają, dostają go jako
+// argument. Dzięki temu kopia alokatora (z własną kopią grafu po wstawieniu
+// zadania) nie może trafić na graf innej kopii.
+class CriticalPathEngine {
+ private:
+  struct Entry {
+    double bottomLevel;
+    int taskID;
+    bool operator<(const Entry& e) const {
+      return bottomLevel != e.bottomLevel ? bottomLevel < e.bottomLevel
+                                          : taskID > e.taskID;
+    }
+  };
+  bool built;
+  std::vector<double> durations;
+  std::vector<double> bottomLevels;
+  std::vector<double> earliestStarts;
+  bool earliestStartsValid = false;
+  std::vector<bool> scheduled;
+  std::priority_queue<Entry> queue; // może zawierać nieaktualne wpisy
+  int nUnscheduled;
+
+  double recompute(const TaskGraph& graph, int taskID) const {
+    auto children = graph.children(taskID);
+    if (children.empty())
+      return durations[taskID];
+    double maxTime = bottomLevels[children[0]];
+    for (auto child : children)
+      if (bottomLevels[child] > maxTime)
+        maxTime = bottomLevels[child];
+    return maxTime + durations[taskID];
+  }
+  double recomputeStart(const TaskGraph& graph, int taskID) const {
+    double start = 0;
+    for (auto parent : graph.parents(taskID))
+      if (earliestStarts[parent] + durations[parent] > start)
+        start = earliestStarts[parent] + durations[parent];
+    return start;
+  }
+
+ public:
+  CriticalPathEngine() : built{false}, nUnscheduled{0} {}
+  ~CriticalPathEngine() {}
+
+  void build(const TaskGraph& graph, std::vector<double> durations_,
+             int nThreads = 1) {
+    built = true;
+    durations = std::move(durations_);
+    int nTasks = graph.getNumberOfTasks();
+    bottomLevels.assign(nTasks, 0);
+    earliestStarts.assign(nTasks, 0);
+    if (nThreads > 1) {
+      // Bottom level: od ujść w górę grafu, earliest start: od korzeni w dół
+      bool acyclic = traverseDag(nTasks, nThreads,
+        [&graph](int t) { return graph.nChildren(t); },
+        [&graph](int t) { return graph.parents(t); },
+        [this, &graph](int t) { bottomLevels[t] = recompute(graph, t); });
+      if (!acyclic)
+        throw std::invalid_argument("Task graph contains a cycle");
+      traverseDag(nTasks, nThreads,
+        [&graph](int t) { return graph.nParents(t); },
+        [&graph](int t) { return graph.children(t); },
+        [this, &graph](int t) {
+          earliestStarts[t] = recomputeStart(graph, t);
+        });
+    } else {
+      auto order = graph.topologicalOrder();
+      if ((int)order.size() != nTasks)
+        throw std::invalid_argument("Task graph contains a cycle");
+      for (int i = nTasks - 1; i >= 0; --i)
+        bottomLevels[order[i]] = recompute(graph, order[i]);
+      for (int i = 0; i < nTasks; ++i)
+        earliestStarts[order[i]] = recomputeStart(graph, order[i]);
+    }
+    earliestStartsValid = true;
+    scheduled.assign(nTasks, false);
+    std::vector<Entry> entries(nTasks);
+    for (int t = 0; t < nTasks; ++t)
+      entries[t] = Entry{bottomLevels[t], t};
+    queue = std::priority_queue<Entry>(std::less<Entry>(), std::move(entries));
+    nUnscheduled = nTasks;
+  }
+
+  void setDuration(const TaskGraph& graph, int taskID, double duration) {
+    // Zmiana czasu wykonania zadania (np. po zmianie zasobu). Nowe wartości
+    // propagowane są w górę grafu tylko dopóki bottom level się zmienia.
+    durations[taskID] = duration;
+    std::vector<int> worklist{taskID};
+    while (!worklist.empty()) {
+      int t = worklist.back();
+      worklist.pop_back();
+      double bl = recompute(graph, t);
+      if (bl == bottomLevels[t])
+        continue;
+      bottomLevels[t] = bl;
+      if (!scheduled[t])
+        queue.push(Entry{bl, t});
+      for (auto parent : graph.parents(t))
+        worklist.push_back(parent);
+    }
+    earliestStartsValid = false;
+  }
+
+  void addTask(const TaskGraph& graph, int taskID, double duration) {
+    // Nowe zadanie (ID = dotychczasowa liczba zadań), już dopisane do grafu
+    // razem z krawędziami. Dodanie zadania może tylko wydłużyć ścieżki jego
+    // przodków, więc rodzic jest odwiedzany tylko wtedy, gdy ścieżka przez
+    // dziecko jest dłuższa od jego obecnej (bez przeliczania wszystkich
+    // dzieci jak w setDuration).
+    durations.push_back(duration);
+    bottomLevels.push_back(recompute(graph, taskID));
+    earliestStartsValid = false;
+    scheduled.push_back(false);
+    nUnscheduled++;
+    queue.push(Entry{bottomLevels[taskID], taskID});
+    std::vector<int> worklist{taskID};
+    while (!worklist.empty()) {
+      int t = worklist.back();
+      worklist.pop_back();
+      for (auto parent : graph.parents(t)) {
+        double bl = durations[parent] + bottomLevels[t];
+        if (bl <= bottomLevels[parent])
+          continue;
+        bottomLevels[parent] = bl;
+        if (!scheduled[parent])
+          queue.push(Entry{bl, parent});
+        worklist.push_back(parent);
+      }
+    }
+  }
+
+  bool isBuilt() const { return built; }
+
+  void markScheduled(int taskID) {
+    if (!scheduled[taskID]) {
+      scheduled[taskID] = true;
+      nUnscheduled--;
+    }
+  }
+
+  int popNext() {
+    // Zwraca nieposzeregowane zadanie o najdłuższej ścieżce krytycznej i
+    // oznacza je jako poszeregowane (-1 jeśli wszystkie już są).
+    while (!queue.empty()) {
+      Entry e = queue.top();
+      queue.pop();
+      if (scheduled[e.taskID] || e.bottomLevel != bottomLevels[e.taskID])
+        continue;
+      markScheduled(e.taskID);
+      return e.taskID;
+    }
+    return -1;
+  }
+
+  double bottomLevel(int taskID) const { return bottomLevels[taskID]; }
+  double earliestStart(const TaskGraph& graph, int taskID) {
+    // Po setDuration / addTask starty są przeliczane (sekwencyjnie) dopiero
+    // przy pierwszym odczycie - szeregowanie z nich nie korzysta
+    if (!earliestStartsValid) {
+      auto order = graph.topologicalOrder();
+      earliestStarts.assign(graph.getNumberOfTasks(), 0);
+      for (auto t : order)
+        earliestStarts[t] = recomputeStart(graph, t);
+      earliestStartsValid = true;
+    }
+    return earliestStarts[taskID];
+  }
+  int getNumberOfUnscheduled() const { return nUnscheduled; }
+};
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef DAG_TRAVERSAL_H
+#define DAG_TRAVERSAL_H
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Równoległe przejście DAG-u w porządku zależności: zadanie jest odwiedzane
+// dopiero po odwiedzeniu wszystkich zadań, od których zależy. Każde zadanie
+// ma atomowy licznik nieprzetworzonych zależności; wątek, który zmniejszy go
+// do zera, wstawia zadanie do swojej kolejki. Wątki biorą zadania z końca
+// własnej kolejki, a gdy jest pusta - kradną z początku kolejek pozostałych
+// wątków (work stealing), więc praca rozkłada się sama także na wąskich,
+// nieregularnych fragmentach grafu. Pierwsze zwolnione zadanie wątek
+// przetwarza od razu, bez kolejki - na łańcuchach zadań nie ma wtedy żadnych
+// operacji na kolejkach.
+//   nDependencies(t) - liczba zależności zadania t,
+//   dependents(t)    - zadania zależne od t (zakres ID),
+//   visit(t)         - przetworzenie zadania; wyniki zależności są już
+//                      widoczne (zmniejszenie licznika to acq_rel).
+// Zwraca false, jeśli nie wszystkie zadania zostały odwiedzone (graf ma
+// cykl). Wątek wywołujący pracuje jako jeden z nThreads wątków.
+template<typename Dependencies, typename Dependents, typename Visit>
+bool traverseDag(int nTasks, int nThreads, Dependencies nDependencies,
+                 Dependents dependents, Visit visit) {
+  struct alignas(64) WorkQueue {
+    std::mutex mutex;
+    std::deque<int> tasks;
+  };
+  if (nThreads < 1)
+    nThreads = 1;
+  auto pending = std::make_unique<std::atomic<int>[]>(nTasks);
+  auto queues = std::make_unique<WorkQueue[]>(nThreads);
+  // Zadania w kolejkach albo właśnie przetwarzane. Zero oznacza koniec: nowe
+  // zadania są doliczane przed odjęciem tego, które je zwolniło.
+  std::atomic<long> inFlight{0};
+  std::atomic<int> nVisited{0};
+  for (int t = 0, next = 0; t < nTasks; ++t) {
+    pending[t].store(nDependencies(t), std::memory_order_relaxed);
+    if (pending[t].load(std::memory_order_relaxed) == 0) {
+      queues[next++ % nThreads].tasks.push_back(t);
+      inFlight.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+  auto work = [&](int self) {
+    auto& own = queues[self];
+    int visited = 0;
+    int t = -1; // zadanie zwolnione przez poprzednie, przetwarzane od razu
+    while (t != -1 || inFlight.load(std::memory_order_acquire) > 0) {
+      if (t == -1) {
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+          t = own.tasks.back();
+          own.tasks.pop_back();
+        }
+      }
+      for (int k = 1; t == -1 && k < nThreads; ++k) {
+        auto& victim = queues[(self + k) % nThreads];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+          t = victim.tasks.front();
+          victim.tasks.pop_front();
+        }
+      }
+      if (t == -1) {
+        std::this_thread::yield();
+        continue;
+      }
+      visit(t);
+      ++visited;
+      int next = -1;
+      for (auto d : dependents(t))
+        if (pending[d].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+          inFlight.fetch_add(1, std::memory_order_relaxed);
+          if (next == -1) {
+            next = d;
+            continue;
+          }
+          std::lock_guard<std::mutex> lock(own.mutex);
+          own.tasks.push_back(d);
+        }
+      inFlight.fetch_sub(1, std::memory_order_release);
+      t = next;
+    }
+    nVisited.fetch_add(visited, std::memory_order_relaxed);
+  };
+  std::vector<std::thread> workers{};
+  for (int i = 1; i < nThreads; ++i)
+    workers.emplace_back(work, i);
+  work(0);
+  for (auto& worker : workers)
+    worker.join();
+  return nVisited.load() == nTasks;
+}
+
+#endif
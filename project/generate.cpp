@@ -0,0 +1,31 @@
+#include <iostream>
+#include <string>
+#include "generator.hpp"
+
+int main(int argc, char *argv[]) {
+  if (argc < 3) {
+    std::cout << "\nGenerate a synthetic task graph specification:\n\n"
+      << "  $ ./generate [output] [tasks] [fan-out] [PEs] [channels]"
+      << " [unpredicted ratio] [seed] [window]\n\n"
+      << "  Defaults: fan-out 3, 5 PEs, 3 channels, ratio 0, seed 1,"
+      << " window 100\n  (successors are drawn from the next [window] tasks;"
+      << " a larger window gives\n  a wider graph with fewer levels).\n\n";
+    return 0;
+  }
+  GeneratorOptions options{};
+  options.nTasks = std::stoi(std::string(argv[2]));
+  if (argc > 3) options.fanOut = std::stod(std::string(argv[3]));
+  if (argc > 4) options.nPE = std::stoi(std::string(argv[4]));
+  if (argc > 5) options.nChannels = std::stoi(std::string(argv[5]));
+  if (argc > 6) options.unpredictedRatio = std::stod(std::string(argv[6]));
+  if (argc > 7) options.seed = std::stoull(std::string(argv[7]));
+  if (argc > 8) options.window = std::stoi(std::string(argv[8]));
+  long nEdges = generateSpecification(options, std::string(argv[1]));
+  if (nEdges == -1) {
+    std::cout << "The output file cannot be written.\n";
+    return 1;
+  }
+  std::cout << argv[1] << ": " << options.nTasks << " tasks, " << nEdges
+            << " edges\n";
+  return 0;
+}
@@ -0,0 +1,89 @@
+#include "generator.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+long generateSpecification(const GeneratorOptions& options,
+                           const std::string& filepath) {
+  std::unique_ptr<std::FILE, int (*)(std::FILE*)> file(
+    std::fopen(filepath.c_str(), "w"), std::fclose);
+  if (!file)
+    return -1;
+  std::FILE* f = file.get();
+  std::mt19937_64 rng(options.seed);
+  int n = options.nTasks;
+  int nPE = std::max(options.nPE, 1);
+  int nChannels = std::max(options.nChannels, 1);
+  int maxSuccessors = std::max(0, (int)(2 * options.fanOut + 0.5));
+  std::uniform_int_distribution<int> successorCount(0, maxSuccessors);
+  std::uniform_int_distribution<int> transfer(1, 100);
+  std::uniform_real_distribution<double> unit(0, 1);
+
+  // @tasks
+  long nEdges = 0;
+  std::vector<int> successors{};
+  std::fprintf(f, "@tasks %d\n", n);
+  for (int t = 0; t < n; ++t) {
+    successors.clear();
+    int last = std::min(n - 1, t + std::max(options.window, 1));
+    if (last > t) {
+      std::uniform_int_distribution<int> target(t + 1, last);
+      int k = std::min(successorCount(rng), last - t);
+      while ((int)successors.size() < k) {
+        int s = target(rng);
+        if (std::find(successors.begin(), successors.end(), s) ==
+            successors.end())
+          successors.push_back(s);
+      }
+      std::sort(successors.begin(), successors.end());
+    }
+    bool unpredicted = unit(rng) < options.unpredictedRatio;
+    std::fprintf(f, "%sT%d %d", unpredicted ? "u" : "", t,
+                 (int)successors.size());
+    for (auto s : successors)
+      std::fprintf(f, " %d(%d)", s, transfer(rng));
+    std::fputc('\n', f);
+    nEdges += successors.size();
+  }
+
+  // @proc: najpierw PP (uniwersalne), potem HC
+  int nPP = std::max(1, nPE / 2);
+  std::uniform_int_distribution<int> price(100, 2000);
+  std::fprintf(f, "@proc %d\n", nPE);
+  for (int p = 0; p < nPE; ++p)
+    std::fprintf(f, "%d 0 %d\n", p < nPP ? price(rng) / 4 : price(rng),
+                 p < nPP ? 1 : 0);
+
+  // @times i @cost: HC są szybkie i mają tylko koszt zakupu, PP wolniejsze
+  std::uniform_int_distribution<int> fast(1, 30);
+  std::uniform_int_distribution<int> slow(20, 300);
+  std::uniform_int_distribution<int> taskCost(1, 100);
+  std::fprintf(f, "@times\n");
+  for (int t = 0; t < n; ++t) {
+    for (int p = 0; p < nPE; ++p)
+      std::fprintf(f, p ? " %d" : "%d", p < nPP ? slow(rng) : fast(rng));
+    std::fputc('\n', f);
+  }
+  std::fprintf(f, "@cost\n");
+  for (int t = 0; t < n; ++t) {
+    for (int p = 0; p < nPE; ++p)
+      std::fprintf(f, p ? " %d" : "%d", p < nPP ? taskCost(rng) : 0);
+    std::fputc('\n', f);
+  }
+
+  // @comm: CHAN0 łączy wszystkie typy PE, pozostałe losowy podzbiór
+  std::uniform_int_distribution<int> channelCost(10, 100);
+  std::uniform_int_distribution<int> bandwidth(1, 10);
+  std::fprintf(f, "@comm %d\n", nChannels);
+  for (int c = 0; c < nChannels; ++c) {
+    std::fprintf(f, "CHAN%d %d %d", c, channelCost(rng), bandwidth(rng));
+    for (int p = 0; p < nPE; ++p)
+      std::fprintf(f, " %d", c == 0 || unit(rng) < 0.5 ? 1 : 0);
+    std::fputc('\n', f);
+  }
+  if (std::ferror(f))
+    return -1;
+  return nEdges;
+}
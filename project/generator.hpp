@@ -0,0 +1,26 @@
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+#include <cstdint>
+#include <string>
+
+// Parametry syntetycznego grafu zadań zapisywanego w formacie
+// @tasks/@proc/@times/@cost/@comm.
+struct GeneratorOptions {
+  int nTasks = 1000;
+  double fanOut = 3; // średnia liczba następników zadania
+  int window = 100; // następniki wybierane spośród kolejnych window zadań
+  int nPE = 5; // liczba typów PE
+  int nChannels = 3;
+  double unpredictedRatio = 0; // ułamek zadań nieprzewidzianych (u)
+  std::uint64_t seed = 1;
+};
+
+// Zapisuje graf do pliku. Graf jest acykliczny (krawędzie tylko do zadań o
+// większym ID), pierwsza szyna łączy wszystkie typy PE, a uniwersalne PE (PP)
+// są na początku @proc, więc każdy wygenerowany plik jest poprawnym wejściem
+// dla obu trybów programu. Zwraca liczbę krawędzi albo -1 przy błędzie zapisu.
+long generateSpecification(const GeneratorOptions& options,
+                           const std::string& filepath);
+
+#endif
@@ -0,0 +1,43 @@
+#include "loader.hpp"
+#include "compiledGraph.hpp"
+#include "parser.hpp"
+
+std::unique_ptr<ResourceAllocator> loadResourceAllocator(
+  const std::string& filepath, double t_max, double c_max, bool debug) {
+  if (isCompiledTaskGraph(filepath)) {
+    CompiledGraph g{};
+    if (loadCompiledTaskGraph(filepath, g) == -1)
+      return nullptr;
+    return std::make_unique<ResourceAllocator>(std::move(g), t_max, c_max);
+  }
+  Parser p{};
+  if (p.read(filepath) == -1)
+    return nullptr;
+  return createResourceAllocator(p, t_max, c_max, debug);
+}
+
+std::unique_ptr<ResourceAllocator> parseResourceAllocator(
+  const std::string& name, std::string_view text, double t_max,
+  double c_max) {
+  Parser p{};
+  if (p.parse(text.data(), text.data() + text.size(), name) == -1)
+    return nullptr;
+  return createResourceAllocator(p, t_max, c_max, false);
+}
+
+std::unique_ptr<ResourceAllocator> createResourceAllocator(
+  Parser& p, double t_max, double c_max, bool debug) {
+  LOG_AT(LOG_DEBUG) {
+    if (debug)
+      p.debug();
+  }
+  // Graf i duże tabele przechodzą do alokatora bez kopiowania
+  return std::make_unique<ResourceAllocator>(std::move(p.getTaskGraph()),
+                                             std::move(p.getProcMatrix()),
+                                             std::move(p.getTimesMatrix()),
+                                             std::move(p.getCostMatrix()),
+                                             p.getCommMatrix(),
+                                             p.getUnpredictedTasksMask(),
+                                             t_max,
+                                             c_max);
+}
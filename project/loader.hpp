@@ -0,0 +1,29 @@
+#ifndef LOADER_H
+#define LOADER_H
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include "parser.hpp"
+#include "resourceAllocator.hpp"
+
+// Tworzy ResourceAllocator ze specyfikacji tekstowej albo skompilowanego
+// pliku .tgb (rozpoznawanego po nagłówku). Zwraca nullptr, jeśli pliku nie
+// da się wczytać (komunikat jest już wypisany). debug = true wypisuje na
+// cerr zawartość wczytanych tabel (Parser::debug).
+std::unique_ptr<ResourceAllocator> loadResourceAllocator(
+  const std::string& filepath, double t_max, double c_max, bool debug);
+
+// Jak wyżej, ale specyfikacja tekstowa jest już w pamięci (name służy tylko
+// do komunikatów o błędach).
+std::unique_ptr<ResourceAllocator> parseResourceAllocator(
+  const std::string& name, std::string_view text, double t_max,
+  double c_max);
+
+// ResourceAllocator z tabel wczytanych już przez Parser. Graf zadań oraz
+// tabele proc, times i cost są przenoszone do alokatora, więc po wywołaniu
+// Parser nie nadaje się do ponownego użycia (poza read/parse od nowa).
+std::unique_ptr<ResourceAllocator> createResourceAllocator(
+  Parser& p, double t_max, double c_max, bool debug);
+
+#endif
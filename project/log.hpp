@@ -0,0 +1,28 @@
+#ifndef LOG_H
+#define LOG_H
+
+// Poziomy komunikatów diagnostycznych (strumień trace / std::cerr):
+//   LOG_INFO  - przebieg algorytmu (np. przydział kolejnego zadania),
+//   LOG_DEBUG - zrzuty struktur danych (Parser::debug, ResourceAllocator::debug),
+//   LOG_TRACE - komunikaty z pętli wewnętrznych (współczynniki, połączenia
+//               z rodzicem, przeliczanie czasów).
+// Poziom maksymalny ustala się przy kompilacji, np. -DLOG_LEVEL=LOG_NONE dla
+// wersji produkcyjnej - komunikaty powyżej tego poziomu nie są wtedy w ogóle
+// generowane (łącznie z formatowaniem liczb). Domyślnie wkompilowane jest
+// wszystko, a poziom można dodatkowo obniżyć w czasie działania (logLevel).
+enum LogLevel { LOG_NONE, LOG_INFO, LOG_DEBUG, LOG_TRACE };
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_TRACE
+#endif
+
+inline LogLevel logLevel = LOG_LEVEL;
+
+// Użycie: LOG_AT(LOG_TRACE) *trace << "..." << '\n';
+//         LOG_AT(LOG_DEBUG) { ...kilka instrukcji... }
+// Uwaga: tak jak każdy makro-if, nie należy go umieszczać bez nawiasów
+// klamrowych przed else.
+#define LOG_AT(level) \
+  if constexpr ((level) > LOG_LEVEL) {} else if ((level) <= logLevel)
+
+#endif
@@ -1,55 +1,208 @@
 #include "parser.hpp"
 #include "utilities.hpp"
 #include "resourceAllocator.hpp"
+#include "compiledGraph.hpp"
+#include "loader.hpp"
+#include "sweep.hpp"
+#include "batch.hpp"
+#include "server.hpp"
+#include "threadPool.hpp"
+#include "log.hpp"
+#include "perf.hpp"
+#include "allocationReport.hpp"
 
-int main(int argc, char *argv[]) {
+int run(int argc, char *argv[]) {
+  bool fillGaps = false;
+  int nAllocationThreads = 0; // 0 - przydział i ścieżki sekwencyjnie
+  ReportFormat format = ReportFormat::Text;
+  std::string checkpointPath{}, resumePath{};
+  int checkpointInterval = 0;
+  // Opcje przed [data] mogą wystąpić w dowolnej kolejności
+  while (argc > 1) {
+    std::string option(argv[1]);
+    int used = 0; // liczba zużytych argumentów (z nazwą opcji)
+    if (option == "--fill-gaps") {
+      fillGaps = true;
+      used = 1;
+    } else if (argc > 2 && option == "--parallel") {
+      nAllocationThreads = std::stoi(std::string(argv[2]));
+      used = 2;
+    } else if (argc > 2 && option == "--format") {
+      if (!parseReportFormat(std::string(argv[2]), format)) {
+        std::cout << "Unknown output format, expected text, csv, jsonl"
+                  << " or bin.\n";
+        return 0;
+      }
+      used = 2;
+    } else if (argc > 3 && option == "--checkpoint") {
+      checkpointPath = argv[2];
+      checkpointInterval = std::stoi(std::string(argv[3]));
+      if (checkpointInterval <= 0) {
+        std::cout << "The checkpoint interval must be a positive number of"
+                  << " tasks.\n";
+        return 0;
+      }
+      used = 3;
+    } else if (argc > 2 && option == "--resume") {
+      resumePath = argv[2];
+      used = 2;
+    } else {
+      break;
+    }
+    argc -= used;
+    argv += used;
+  }
+  if (argc == 4 && std::string(argv[1]) == "--compile")
+    return compileTaskGraph(std::string(argv[2]), std::string(argv[3]));
+  if ((argc == 6 || argc == 7) && std::string(argv[1]) == "--sweep") {
+    SweepRange times{}, costs{};
+    if (!parseSweepRange(argv[3], times) || !parseSweepRange(argv[4], costs)) {
+      std::cout << "Invalid range, expected [from:to:step] or [value].\n";
+      return 0;
+    }
+    int nThreads = argc == 7 ? std::stoi(std::string(argv[6]))
+                             : ThreadPool::defaultSize();
+    return runSweep(std::string(argv[2]), times, costs, std::string(argv[5]),
+                    nThreads);
+  }
+  if ((argc == 4 || argc == 5) && std::string(argv[1]) == "--batch") {
+    int nThreads = argc == 5 ? std::stoi(std::string(argv[4]))
+                             : ThreadPool::defaultSize();
+    return runBatch(std::string(argv[2]), std::string(argv[3]), nThreads);
+  }
+  if (argc >= 3 && argc <= 5 && std::string(argv[1]) == "--server") {
+    int nThreads = argc >= 4 ? std::stoi(std::string(argv[3]))
+                             : ThreadPool::defaultSize();
+    long maxPutBytes = argc == 5 ? std::stol(std::string(argv[4])) << 20
+                                 : defaultMaxPutBytes;
+    if (maxPutBytes <= 0) {
+      std::cout << "The PUT size limit must be a positive number of MB.\n";
+      return 0;
+    }
+    return runServer(std::string(argv[2]), nThreads, maxPutBytes);
+  }
+  if (argc >= 4 && std::string(argv[1]) == "--client")
+    return runClient(std::string(argv[2]),
+                     std::vector<std::string>(argv + 3, argv + argc));
   if (argc < 5) {
     std::cout << "\nRun the program as the following:\n\n"
-      << "  $ ./program [data] [max time] [max cost] [choice]\n"
+      << "  $ ./program [data] [max time] [max cost] [choice] [log level]\n"
       << "\n  Choice = 1: using a structural algorithm;\n"
-      << "  Choice = 2: handling unpredicted tasks.\n\n";
+      << "  Choice = 2: handling unpredicted tasks;\n"
+      << "  Choice = 3: HEFT list scheduling (upward rank, earliest finish"
+      << " time).\n"
+      << "\n  Log level (stderr, default 3): 0 = none, 1 = info, 2 = debug,"
+      << " 3 = trace.\n"
+      << "\n  Structural algorithm placing tasks in idle gaps of PE instances:\n"
+      << "  $ ./program --fill-gaps [data] [max time] [max cost] 1\n"
+      << "  (choices 2 and 3 do not accept --fill-gaps)\n"
+      << "\n  Structural algorithm level by level, scoring on [threads]"
+      << " threads:\n"
+      << "  $ ./program --parallel [threads] [data] [max time] [max cost] 1\n"
+      << "  (with choice 2, critical paths are computed on [threads]"
+      << " threads;\n  choice 3 does not accept --parallel)\n"
+      << "\n  Results written at once as colored text (default), CSV,"
+      << " JSON Lines or binary:\n"
+      << "  $ ./program --format [text/csv/jsonl/bin] [data] [max time]"
+      << " [max cost] [choice]\n"
+      << "\n  Structural algorithm writing a snapshot every [interval] tasks"
+      << " and resuming from it:\n"
+      << "  $ ./program --checkpoint [file] [interval] [data] [max time]"
+      << " [max cost] 1\n"
+      << "  $ ./program --resume [file] [data] [max time] [max cost] 1\n"
+      << "  (--fill-gaps and the limits must match the interrupted run)\n"
+      << "\n  --fill-gaps, --parallel, --format, --checkpoint and --resume"
+      << " can be given in any order.\n"
+      << "\n  [data] can be a specification file or a compiled .tgb file:\n"
+      << "  $ ./program --compile [data] [output.tgb]\n"
+      << "\n  Parameter sweep of the structural algorithm (CSV output):\n"
+      << "  $ ./program --sweep [data] [time from:to:step] [cost from:to:step]"
+      << " [output.csv] [threads]\n"
+      << "\n  Many specifications in one process (manifest lines: [data]"
+      << " [max time] [max cost] [choice]):\n"
+      << "  $ ./program --batch [manifest] [output] [threads]\n"
+      << "\n  Allocation server on a Unix socket and a test client:\n"
+      << "  $ ./program --server [socket] [threads] [max PUT size in MB,"
+      << " default 256]\n"
+      << "  $ ./program --client [socket] RUN [data] [max time] [max cost]"
+      << " [choice]\n"
+      << "  $ ./program --client [socket] PUT [name] [data]\n"
+      << "  $ ./program --client [socket] STATS\n"
+      << "  $ ./program --client [socket] SHUTDOWN\n"
+      << "\n  Any of the above can be preceded by --perf [report.json] to write"
+      << "\n  call counters, phase times and peak memory on exit.\n\n";
     return 0;
   }
 
-  Parser p{};
-  if (p.read(std::string(argv[1])) == -1)
+  std::string filepath(argv[1]);
+  double t_max = std::stod(std::string(argv[2]));
+  double c_max = std::stod(std::string(argv[3]));
+  if (argc > 5)
+    logLevel = LogLevel(std::stoi(std::string(argv[5])));
+  auto allocator = loadResourceAllocator(filepath, t_max, c_max, true);
+  if (!allocator)
     return 0;
-  auto tasksAdjacencyMatrix = p.getTasksAdjacencyMatrix();
-  auto procMatrix = p.getProcMatrix();
-  auto timesMatrix = p.getTimesMatrix();
-  auto costMatrix = p.getCostMatrix();
-  auto commMatrix = p.getCommMatrix();
-  auto tasksMatrix = p.getTasksMatrix();
-  auto unpredictedTasksMask = p.getUnpredictedTasksMask();
-  p.debug();
-
-  ResourceAllocator r{tasksAdjacencyMatrix,
-                      procMatrix,
-                      timesMatrix,
-                      costMatrix,
-                      commMatrix,
-                      tasksMatrix,
-                      unpredictedTasksMask,
-                      std::stod(std::string(argv[2])),
-                      std::stod(std::string(argv[3]))};
+  ResourceAllocator& r = *allocator;
+  r.setGapFilling(fillGaps);
+  if (nAllocationThreads > 0)
+    r.setCriticalPathThreads(nAllocationThreads);
   
   int choice = std::stod(std::string(argv[4]));
+  if (choice < 1 || choice > 3)
+    return 0;
+  if (choice != 1 && fillGaps) {
+    std::cout << "Gap filling is part of the structural algorithm (choice 1)"
+              << " only, --fill-gaps cannot be used with choice " << choice
+              << ".\n";
+    return 0;
+  }
+  if (choice == 3 && nAllocationThreads > 0) {
+    std::cout << "HEFT (choice 3) runs sequentially, --parallel cannot be"
+              << " used with it.\n";
+    return 0;
+  }
+  if ((!checkpointPath.empty() || !resumePath.empty()) &&
+      (choice != 1 || nAllocationThreads > 0)) {
+    std::cout << "Checkpoints are supported by the sequential structural"
+              << " algorithm (choice 1 without --parallel) only.\n";
+    return 0;
+  }
+  // Wyniki są zbierane w pamięci i formatowane (nagłówki, kolory) dopiero
+  // na końcu, jednym zapisem
+  AllocationReport report{};
+  report.mode = choice;
+  r.setOutput(&report, std::cerr);
+  if (!resumePath.empty() && r.readCheckpoint(resumePath) == -1)
+    return 0;
+  r.setCheckpoint(checkpointPath, checkpointInterval);
   if (choice == 1) {
-    std::cout << "\n\e[32m\e[1mAlokacja zasobów metodą standaryzacji:\e[0m\n";
-    for (int t = 0; t < tasksMatrix.d1; ++t) {
-      r.allocate(t);
-    }
-    std::cout << "\n\e[34mCałkowity czas wykonania:\e[0m " << r.getOverallTime() 
-      << '\n';
-    std::cout << "\e[34mCałkowity koszt:\e[0m " << r.getOverallCost() << '\n';
-    std::cout << '\n';
+    if (nAllocationThreads > 0)
+      r.allocateAllParallel(nAllocationThreads);
+    else
+      r.allocateAll();
+    report.setTotals(r.getOverallTime(), r.getOverallCost());
+  } else if (choice == 3) {
+    r.allocateUpwardRank();
+    report.setTotals(r.getOverallTime(), r.getOverallCost());
   } else if (choice == 2) {
-    r.debug();
-    std::cout << "\n\e[32m\e[1mPoczątkowy przydział zasobów\e[0m\n";
+    LOG_AT(LOG_DEBUG) r.debug();
     r.allocateMinTime();
-    std::cout << "\n\e[34m\e[1mPoszeregowane zadania "
-      << "(w tym nieprzewidziane):\e[0m\n";
     r.scheduleAllTasks();
-    std::cout << '\n';
   }
+  writeReport(report, format, std::cout);
+  return 0;
+}
+
+int main(int argc, char *argv[]) {
+  std::string perfReportPath{};
+  if (argc > 2 && std::string(argv[1]) == "--perf") {
+    perf.enabled = true;
+    perfReportPath = argv[2];
+    argc -= 2;
+    argv += 2;
+  }
+  int result = run(argc, argv);
+  if (perf.enabled)
+    writePerfReport(perfReportPath);
+  return result;
 }
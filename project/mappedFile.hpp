@@ -0,0 +1,66 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Plik zmapowany do pamięci (POSIX mmap). Zawartość jest dostępna przez
+// data()/size() do końca życia obiektu. Przy copyOnWrite strony można
+// modyfikować, ale zmiany są prywatne i nie trafiają do pliku.
+class MappedFile {
+ private:
+  const char* begin;
+  std::size_t length;
+  void* mapping;
+ public:
+  MappedFile() : begin{nullptr}, length{0}, mapping{MAP_FAILED} {}
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  ~MappedFile() { close(); }
+
+  bool open(const std::string& filepath, bool copyOnWrite = false) {
+    // Zwraca false, jeśli pliku nie da się otworzyć. Pusty plik nie jest
+    // mapowany (mmap nie przyjmuje długości 0), ale open() się udaje.
+    close();
+    int fd = ::open(filepath.c_str(), O_RDONLY);
+    if (fd == -1)
+      return false;
+    struct stat st;
+    if (fstat(fd, &st) == -1 || !S_ISREG(st.st_mode)) {
+      ::close(fd);
+      return false;
+    }
+    length = st.st_size;
+    if (length > 0) {
+      mapping = mmap(nullptr, length,
+        copyOnWrite ? PROT_READ | PROT_WRITE : PROT_READ, MAP_PRIVATE, fd, 0);
+      if (mapping == MAP_FAILED) {
+        ::close(fd);
+        length = 0;
+        return false;
+      }
+      madvise(mapping, length, MADV_SEQUENTIAL);
+      begin = static_cast<const char*>(mapping);
+    }
+    ::close(fd);
+    return true;
+  }
+
+  void close() {
+    if (mapping != MAP_FAILED)
+      munmap(mapping, length);
+    mapping = MAP_FAILED;
+    begin = nullptr;
+    length = 0;
+  }
+
+  const char* data() const { return begin; }
+  char* mutableData() { return static_cast<char*>(mapping); }
+  std::size_t size() const { return length; }
+};
+
+#endif
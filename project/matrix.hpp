@@ -1,42 +1,113 @@
-#ifndef MATRIX_H
-#define MATRIX_H
-
-#include <vector>
-
-template<typename T>
-class Matrix {
- typedef std::vector<std::vector<T>> TwoDimMatrix;
- typedef std::vector<T> OneDimMatrix;
- private:
-  TwoDimMatrix elem;
- public:
-  int d1;
-  int d2;
-  Matrix() : elem{}, d1{}, d2{} {}
-  ~Matrix() {}
-  OneDimMatrix& operator[](int i) { return elem[i]; }
-  OneDimMatrix operator[](int i) const { return elem[i]; }
-  void build(int d1_, int d2_) {
-    for (int i = 0; i < d1_; ++i)
-      elem.push_back(std::vector<T>(d2_));
-    d1 = d1_;
-    d2 = d2_;
-  }
-  Matrix(const Matrix<T>& m) {
-    for (auto e : m.elem)
-      elem.push_back(e);
-    d1 = m.d1;
-    d2 = m.d2;
-  };
-  Matrix<T>& operator=(const Matrix<T>& m) {
-    TwoDimMatrix temp{};
-    for (auto e : m.elem)
-      temp.push_back(e);
-    elem = temp;
-    d1 = m.d1;
-    d2 = m.d2;
-    return *this;
-  };
-};
-
-#endif
\ No newline at end of file
+#ifndef MATRIX_H
+#define MATRIX_H
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <utility>
+
+// Macierz d1 x d2 przechowywana w jednym ciągłym buforze (row-major).
+// operator[] zwraca widok wiersza (std::span) bez kopiowania danych, więc
+// odwołania typu times[t][procID] to jedno mnożenie i jeden odczyt z pamięci.
+// Bufor jest alokowany jako T[] (a nie std::vector<T>), żeby Matrix<bool>
+// również miała ciągłą pamięć i widoki wierszy.
+// appendRow dopisuje wiersz na końcu (bufor rośnie geometrycznie, np. przy
+// dodawaniu zadań w trakcie działania - patrz insertUnpredictedTask).
+// Macierz może też wskazywać na cudzą pamięć (np. zmapowany plik .tgb, patrz
+// Matrix::view) - wtedy owner utrzymuje tę pamięć przy życiu, a kopia
+// macierzy jest już zwykłą macierzą z własnym buforem.
+template<typename T>
+class Matrix {
+ typedef std::span<T> Row;
+ typedef std::span<const T> ConstRow;
+ private:
+  std::unique_ptr<T[]> elem;
+  T* ptr; // elem.get() albo pamięć zewnętrzna
+  std::shared_ptr<void> owner;
+  int capacity; // liczba wierszy, na które starczy elem (0 dla view)
+ public:
+  int d1;
+  int d2;
+  Matrix() : elem{}, ptr{nullptr}, owner{}, capacity{0}, d1{}, d2{} {}
+  ~Matrix() {}
+  static Matrix<T> view(T* data_, int d1_, int d2_,
+                        std::shared_ptr<void> owner_) {
+    Matrix<T> m{};
+    m.ptr = data_;
+    m.owner = std::move(owner_);
+    m.d1 = d1_;
+    m.d2 = d2_;
+    return m;
+  }
+  Row operator[](int i) {
+    return Row(ptr + static_cast<std::size_t>(i) * d2, d2);
+  }
+  ConstRow operator[](int i) const {
+    return ConstRow(ptr + static_cast<std::size_t>(i) * d2, d2);
+  }
+  T* data() { return ptr; }
+  const T* data() const { return ptr; }
+  std::size_t size() const { return static_cast<std::size_t>(d1) * d2; }
+  void build(int d1_, int d2_) {
+    d1 = d1_;
+    d2 = d2_;
+    elem = std::make_unique<T[]>(size()); // wartości zainicjalizowane zerami
+    ptr = elem.get();
+    owner.reset();
+    capacity = d1;
+  }
+  void appendRow(std::span<const T> row) {
+    if (d1 >= capacity) {
+      int newCapacity = std::max(4, 2 * d1);
+      auto grown = std::make_unique_for_overwrite<T[]>(
+        static_cast<std::size_t>(newCapacity) * d2);
+      if (ptr)
+        std::copy(ptr, ptr + size(), grown.get());
+      elem = std::move(grown);
+      ptr = elem.get();
+      owner.reset();
+      capacity = newCapacity;
+    }
+    std::copy(row.begin(), row.end(), ptr + size());
+    ++d1;
+  }
+  Matrix(const Matrix<T>& m) : elem{}, ptr{nullptr}, owner{}, capacity{0},
+                               d1{m.d1}, d2{m.d2} {
+    if (m.ptr) {
+      elem = std::make_unique_for_overwrite<T[]>(size());
+      std::copy(m.ptr, m.ptr + size(), elem.get());
+      ptr = elem.get();
+      capacity = d1;
+    }
+  }
+  Matrix(Matrix<T>&& m) noexcept
+      : elem{std::move(m.elem)}, ptr{std::exchange(m.ptr, nullptr)},
+        owner{std::move(m.owner)}, capacity{std::exchange(m.capacity, 0)},
+        d1{m.d1}, d2{m.d2} {
+    m.d1 = 0;
+    m.d2 = 0;
+  }
+  Matrix<T>& operator=(const Matrix<T>& m) {
+    if (this != &m) {
+      Matrix<T> temp{m};
+      *this = std::move(temp);
+    }
+    return *this;
+  }
+  Matrix<T>& operator=(Matrix<T>&& m) noexcept {
+    if (this != &m) {
+      elem = std::move(m.elem);
+      ptr = std::exchange(m.ptr, nullptr);
+      owner = std::move(m.owner);
+      capacity = std::exchange(m.capacity, 0);
+      d1 = m.d1;
+      d2 = m.d2;
+      m.d1 = 0;
+      m.d2 = 0;
+    }
+    return *this;
+  }
+};
+
+#endif
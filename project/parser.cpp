@@ -4,109 +4,112 @@ Parser::Parser() : nTasks{0} {}
 Parser::~Parser() {}
 
 int Parser::read(std::string filepath) {
-  std::ifstream inputFile;
-  inputFile.open(filepath);
-  if (inputFile.is_open()) {
-    
+  MappedFile inputFile;
+  if (!inputFile.open(filepath)) {
+    std::cout << "The input file cannot be opened.\n";
+    return -1;
+  }
+  return parse(inputFile.data(), inputFile.data() + inputFile.size(),
+               filepath);
+}
+
+int Parser::parse(const char* begin, const char* end,
+                  const std::string& name) {
+  PerfTimer timer(PHASE_PARSE);
+  Tokenizer t(begin, end);
+  try {
+    if (t.atEndOfLine())
+      t.nextLine();
+
     // @tasks - header
-    std::regex pat(R"((@tasks) (\d{1,}))");
-    std::string line; 
-    getline(inputFile, line);
-    std::smatch matches;
-    if (std::regex_search(line, matches, pat))
-      nTasks = std::stoi(matches.str(2));
-    tasksAdjacencyMatrix.build(nTasks, nTasks);
-    tasksMatrix.build(nTasks, nTasks);
-    // @tasks - body
-    while (getline(inputFile, line)) {
-      pat = R"((u*)(T)(\d{1,}) (\d{1,}))";
-      if (std::regex_search(line, matches, pat)) {
-        int taskID;
-        bool unpredicted = (matches.str(1) == "u" ? true : false);
-        unpredictedTasksMask.push_back(unpredicted);
-        taskID = std::stoi(matches.str(3));
-        line = matches.suffix().str();
-        pat = R"((\d{1,})\((\d{1,})\))";
-        while (std::regex_search(line, matches, pat)) {
-          int nextTaskID = std::stoi(matches.str(1));
-          int edge = std::stoi(matches.str(2));
-          line = matches.suffix().str();
-          tasksAdjacencyMatrix[taskID][nextTaskID] = true;
-          tasksMatrix[taskID][nextTaskID] = edge;
-        }
-      } else {
-        break;
+    t.expectWord("@tasks");
+    t.skipBlanks();
+    nTasks = t.readInt();
+    t.expectEndOfLine();
+    unpredictedTasksMask.clear();
+    std::vector<Edge> edges{};
+    // @tasks - body: [u]T<id> <liczba następników> <id>(<dane>) ...
+    // Następnik może mieć przedrostek "u"/"uT" (np. "uT10(0)" albo "u12(0)").
+    while (t.peek() != '@' && !t.atEnd()) {
+      bool unpredicted = t.accept('u');
+      t.expect('T');
+      int taskID = t.readInt();
+      if (taskID >= nTasks)
+        t.fail("task T" + std::to_string(taskID) + " out of range");
+      t.skipBlanks();
+      t.readInt();
+      unpredictedTasksMask.push_back(unpredicted);
+      while (!t.atEndOfLine()) {
+        t.accept('u');
+        t.accept('T');
+        int nextTaskID = t.readInt();
+        if (nextTaskID >= nTasks)
+          t.fail("task T" + std::to_string(nextTaskID) + " out of range");
+        t.expect('(');
+        double edge = t.readNumber();
+        t.expect(')');
+        edges.push_back(Edge{taskID, nextTaskID, edge});
       }
+      t.nextLine();
     }
+    if ((int)unpredictedTasksMask.size() != nTasks)
+      t.fail("expected " + std::to_string(nTasks) + " tasks, found " +
+             std::to_string(unpredictedTasksMask.size()));
+    taskGraph.build(nTasks, std::move(edges));
 
     // @proc - header
-    pat = R"((@proc) (\d{1,}))";
-    if (std::regex_search(line, matches, pat))
-      nPE = std::stoi(matches.str(2));
+    t.expectWord("@proc");
+    t.skipBlanks();
+    nPE = t.readInt();
+    t.expectEndOfLine();
     procMatrix.build(nPE, 3);
     // @proc - body
-    pat = R"((\d{1,}) (\d{1,}) (\d{1,}))";
-    for (int i = 0; i < nPE; ++i) {
-      getline(inputFile, line);
-      if (std::regex_search(line, matches, pat)) {
-        procMatrix[i][0] = std::stod(matches.str(1));
-        procMatrix[i][1] = std::stod(matches.str(2));
-        procMatrix[i][2] = std::stod(matches.str(3));
-      }
-    }
+    readRows(t, procMatrix);
 
-    // @times - header
-    getline(inputFile, line);
-    // @times - body
-    pat = R"(\d{1,})";
+    // @times
+    t.expectWord("@times");
+    t.expectEndOfLine();
     timesMatrix.build(nTasks, nPE);
-    for (int i = 0; i < nTasks; ++i) {
-      getline(inputFile, line);
-      for (int j = 0; std::regex_search(line, matches, pat); ++j) {
-        timesMatrix[i][j] = std::stod(matches[0]);
-        line = matches.suffix().str();
-      }
-    }
+    readRows(t, timesMatrix);
 
-    // @cost - header
-    getline(inputFile, line);
-    // @cost - body
-    pat = R"(\d{1,})";
+    // @cost
+    t.expectWord("@cost");
+    t.expectEndOfLine();
     costMatrix.build(nTasks, nPE);
-    for (int i = 0; i < nTasks; ++i) {
-      getline(inputFile, line);
-      for (int j = 0; std::regex_search(line, matches, pat); ++j) {
-        costMatrix[i][j] = std::stod(matches[0]);
-        line = matches.suffix().str();
-      }
-    }
+    readRows(t, costMatrix);
 
     // @comm - header
-    pat = R"((@comm) (\d{1,}))";
-    getline(inputFile, line);
-    if (std::regex_search(line, matches, pat))
-      nChannels = std::stoi(matches.str(2));
+    t.expectWord("@comm");
+    t.skipBlanks();
+    nChannels = t.readInt();
+    t.expectEndOfLine();
     commMatrix.build(nChannels, 2 + nPE);
-    // @comm - body
-    std::regex pat0(R"((CHAN\d{1,}))");
-    pat = R"(\d{1,})";
-    for (int i = 0; i < nChannels; ++i) {
-      getline(inputFile, line);
-      std::regex_search(line, matches, pat0);
-      line = matches.suffix().str();
-      for (int j = 0; std::regex_search(line, matches, pat); ++j) {
-        commMatrix[i][j] = std::stod(matches[0]);
-        line = matches.suffix().str();
-      }
-    }
-    return 0;
-  } else { std::cout << "The input file cannot be opened.\n"; }
-  inputFile.close();
-  return -1;
+    // @comm - body: CHAN<id> <koszt> <przepustowość> <połączenia z PE>
+    readRows(t, commMatrix, "CHAN");
+  } catch (const ParseError& e) {
+    std::cout << name << ":" << e.line << ": " << e.what() << '\n';
+    return -1;
+  }
+  return 0;
+}
+
+void Parser::readRows(Tokenizer& t, Matrix<double>& m, std::string_view prefix) {
+  // Wczytuje m.d1 linii po m.d2 liczb (opcjonalnie poprzedzonych słowem
+  // zaczynającym się od prefix, np. "CHAN0"). Brakujące linie na końcu pliku
+  // zostają wyzerowane, tak jak w poprzedniej wersji parsera (np.
+  // test_unpredicted.txt deklaruje "@comm 2", a opisuje jedną szynę).
+  for (int i = 0; i < m.d1; ++i) {
+    if (t.atEnd())
+      break;
+    if (!prefix.empty() && t.word().substr(0, prefix.size()) != prefix)
+      t.fail("expected '" + std::string(prefix) + "'");
+    for (int j = 0; j < m.d2; ++j)
+      m[i][j] = t.readNumber();
+    t.expectEndOfLine();
+  }
 }
 
-Matrix<bool>& Parser::getTasksAdjacencyMatrix() { return tasksAdjacencyMatrix; }
-Matrix<double>& Parser::getTasksMatrix() { return tasksMatrix; }
+TaskGraph& Parser::getTaskGraph() { return taskGraph; }
 Matrix<double>& Parser::getProcMatrix() { return procMatrix; }
 Matrix<double>& Parser::getTimesMatrix() { return timesMatrix; }
 Matrix<double>& Parser::getCostMatrix() { return costMatrix; }
@@ -118,20 +121,13 @@ void Parser::debug() {
   std::cerr << "  nTasks : " << nTasks << '\n';
   std::cerr << "  nPE : " << nPE << "\n\n";
 
-  std::cerr << "Parser::tasksAdjacencyMatrix:\n";
+  std::cerr << "Parser::taskGraph:\n";
   for (int i = 0; i < nTasks; ++i) {
-    std::cerr << "  "; 
-    for (auto e : tasksAdjacencyMatrix[i]) std::cerr << e
-              << "|";
-    std::cerr << '\n';
-  }
-  std::cerr << '\n';
-
-  std::cerr << "Parser::tasksMatrix:\n";
-  for (int i = 0; i < nTasks; ++i) {
-    std::cerr << "  ";
-    for (auto e : tasksMatrix[i]) 
-      std::cerr << e << "|";
+    std::cerr << "  T" << i << " ->";
+    auto children = taskGraph.children(i);
+    auto weights = taskGraph.childrenWeights(i);
+    for (int k = 0; k < (int)children.size(); ++k)
+      std::cerr << " " << children[k] << "(" << weights[k] << ")";
     std::cerr << '\n';
   }
   std::cerr << '\n';
@@ -3,31 +3,35 @@
 
 #include <iostream>
 #include <string>
+#include <string_view>
 #include "matrix.hpp"
-#include <iostream>
-#include <fstream>
-#include <regex>
+#include "taskGraph.hpp"
+#include "mappedFile.hpp"
+#include "tokenizer.hpp"
+#include "perf.hpp"
 
 class Parser {
  private:
   int nTasks;
   int nPE;
   int nChannels;
-  Matrix<bool> tasksAdjacencyMatrix{};
-  Matrix<double> tasksMatrix{};
+  TaskGraph taskGraph{}; // lista sąsiedztwa (CSR) zbudowana z krawędzi @tasks
   Matrix<double> procMatrix{}; 
   Matrix<double> timesMatrix{};
   Matrix<double> costMatrix{};
   Matrix<double> commMatrix{};
   std::vector<bool> unpredictedTasksMask{}; // [True, False, False] - T1 i T2
                                             // są prewidziane, T0 nieprzewidziane.
+  void readRows(Tokenizer& t, Matrix<double>& m, std::string_view prefix = "");
  public:
   Parser();
   ~Parser();
   int read(std::string filepath);
+  // Wczytanie specyfikacji z pamięci (np. przesłanej przez gniazdo);
+  // name pojawia się w komunikatach o błędach zamiast nazwy pliku
+  int parse(const char* begin, const char* end, const std::string& name);
   void debug();
-  Matrix<bool>& getTasksAdjacencyMatrix();
-  Matrix<double>& getTasksMatrix();
+  TaskGraph& getTaskGraph();
   Matrix<double>& getProcMatrix();
   Matrix<double>& getTimesMatrix();
   Matrix<double>& getCostMatrix();
@@ -0,0 +1,38 @@
+#include "perf.hpp"
+#include <fstream>
+#include <iostream>
+#include <sys/resource.h>
+
+namespace {
+
+const char* counterNames[PERF_NUMBER_OF_COUNTERS] = {
+  "findAllParents", "findBestParent", "findBestChannel", "findBest_std",
+  "findBest_timeCost", "updateCoefficients", "computeCriticalPaths",
+  "allocatedTasks", "insertedTasks"};
+
+const char* phaseNames[PERF_NUMBER_OF_PHASES] = {
+  "parse", "standardise", "allocate", "schedule", "criticalPaths",
+  "insert", "checkpoint"};
+
+}
+
+int writePerfReport(const std::string& filepath) {
+  std::ofstream json(filepath);
+  if (!json.is_open()) {
+    std::cout << "The performance report cannot be written to " << filepath
+              << ".\n";
+    return -1;
+  }
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+  json << "{\n  \"counters\": {";
+  for (int i = 0; i < PERF_NUMBER_OF_COUNTERS; ++i)
+    json << (i ? ",\n" : "\n") << "    \"" << counterNames[i] << "\": "
+         << perf.calls[i].load();
+  json << "\n  },\n  \"phases_s\": {";
+  for (int i = 0; i < PERF_NUMBER_OF_PHASES; ++i)
+    json << (i ? ",\n" : "\n") << "    \"" << phaseNames[i] << "\": "
+         << perf.nanoseconds[i].load() * 1e-9;
+  json << "\n  },\n  \"peak_rss_kb\": " << usage.ru_maxrss << "\n}\n";
+  return 0;
+}
@@ -0,0 +1,80 @@
+#ifndef PERF_H
+#define PERF_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Liczniki wywołań i czasy etapów (parsowanie, standaryzacja, przydział,
+// szeregowanie) do śledzenia regresji wydajności. Domyślnie wyłączone -
+// wtedy każdy punkt pomiarowy to jedno sprawdzenie flagi perf.enabled.
+// Włączane opcją --perf [plik.json]; raport jest zapisywany przy wyjściu
+// z programu (writePerfReport). Liczniki są atomowe, bo przegląd parametrów
+// (--sweep) uruchamia wiele alokatorów równolegle - czasy etapów są wtedy
+// sumą po wątkach.
+enum PerfCounter {
+  PERF_FIND_ALL_PARENTS,
+  PERF_FIND_BEST_PARENT,
+  PERF_FIND_BEST_CHANNEL,
+  PERF_FIND_BEST_STD,
+  PERF_FIND_BEST_TIME_COST,
+  PERF_UPDATE_COEFFICIENTS,
+  PERF_COMPUTE_CRITICAL_PATHS,
+  PERF_ALLOCATED_TASKS,
+  PERF_INSERTED_TASKS,
+  PERF_NUMBER_OF_COUNTERS
+};
+
+enum PerfPhase {
+  PHASE_PARSE,
+  PHASE_STANDARDISE,
+  PHASE_ALLOCATE,
+  PHASE_SCHEDULE,
+  PHASE_CRITICAL_PATHS, // część PHASE_SCHEDULE
+  PHASE_INSERT, // insertUnpredictedTask (bez pełnego przeliczania ścieżek)
+  PHASE_CHECKPOINT, // migawki stanu alokatora (zapis - część PHASE_ALLOCATE)
+  PERF_NUMBER_OF_PHASES
+};
+
+struct PerfStats {
+  bool enabled = false;
+  std::atomic<std::uint64_t> calls[PERF_NUMBER_OF_COUNTERS]{};
+  std::atomic<std::uint64_t> nanoseconds[PERF_NUMBER_OF_PHASES]{};
+};
+
+inline PerfStats perf{};
+
+inline void perfCount(PerfCounter counter) {
+  if (perf.enabled)
+    perf.calls[counter].fetch_add(1, std::memory_order_relaxed);
+}
+
+// Mierzy czas od konstrukcji do końca zakresu i dolicza go do etapu
+class PerfTimer {
+ private:
+  PerfPhase phase;
+  bool active;
+  std::chrono::steady_clock::time_point start{};
+ public:
+  explicit PerfTimer(PerfPhase phase_) : phase{phase_}, active{perf.enabled} {
+    if (active)
+      start = std::chrono::steady_clock::now();
+  }
+  ~PerfTimer() {
+    if (active)
+      perf.nanoseconds[phase].fetch_add(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - start).count(),
+        std::memory_order_relaxed);
+  }
+  PerfTimer(const PerfTimer&) = delete;
+  PerfTimer& operator=(const PerfTimer&) = delete;
+};
+
+// Zapisuje liczniki, czasy etapów (w sekundach) i szczytowe zużycie pamięci
+// (max RSS procesu) w formacie JSON. Zwraca -1, jeśli pliku nie da się
+// utworzyć.
+int writePerfReport(const std::string& filepath);
+
+#endif
@@ -1,150 +1,255 @@
 #ifndef RESOURCE_ALLOCATOR_H
 #define RESOURCE_ALLOCATOR_H
 
+#include <array>
 #include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <queue>
 #include <iostream>
 #include <stdexcept>
 #include <string>
 #include <algorithm>
+#include <utility>
 #include "matrix.hpp"
+#include "taskGraph.hpp"
+#include "criticalPath.hpp"
+#include "compiledGraph.hpp"
+#include "channelIndex.hpp"
+#include "allocatorState.hpp"
+#include "allocatorPolicies.hpp"
+#include "allocationReport.hpp"
+#include "threadPool.hpp"
 #include "utilities.hpp"
+#include "log.hpp"
+#include "perf.hpp"
 
-class ResourceAllocator {
- private:
-  Matrix<bool> tasksAdjacencyMatrix;
+// Dane specyfikacji, których przydział nie zmienia: graf zadań i tabele
+// (także wystandaryzowane). Kopie alokatora (punkty przeglądu parametrów,
+// zlecenia serwera) współdzielą je przez shared_ptr i kopiują tylko stan
+// przydziału; tabele z pliku .tgb zostają przy tym widokami zmapowanego
+// pliku. Dodanie zadania w trakcie działania najpierw robi własną kopię
+// (copy-on-write, patrz mutableSpec).
+struct SpecificationTables {
+  TaskGraph taskGraph; // listy poprzedników i następników każdego zadania
   Matrix<double> proc;
   Matrix<double> times;
   Matrix<double> cost;
   Matrix<double> procStd;
   Matrix<double> costStd;
   Matrix<double> timesStd;
+};
+
+// Strategie oceny zasobów, aktualizacji współczynników i wyboru rodzica są
+// parametrami szablonu (patrz allocatorPolicies.hpp); ResourceAllocator
+// poniżej to alokator ze strategiami domyślnymi.
+template<typename Scoring = StdScoring,
+         typename CoefficientUpdate = MomentumSoftmaxUpdate,
+         typename ParentSelection = EarliestFinishingParent>
+class BasicResourceAllocator {
+ private:
+  std::shared_ptr<const SpecificationTables> spec;
   std::vector<Channel> channels; // wektor przechowujący wszystkie kanały w specyfikacji
-  std::vector<Task> tasks; // wektor przechowujący wszystkie zadania w specyfikacji
-  std::vector<PE> resources; // wszystkie do tej pory zaalokowane jednostki
+  TaskState tasks; // stan wszystkich zadań w specyfikacji
+  InstanceState instances; // wszystkie do tej pory zaalokowane jednostki
+  ChannelIndex channelIndex; // łączność szyn z typami PE (stała)
+  InstanceChannelTable instanceChannels; // szyny każdej z instances
+  std::vector<std::vector<int>> instancesOfType; // uchwyty jednostek wg procID
+  // lastTaskEndTime jednostek z instancesOfType (te same pozycje)
+  std::vector<EndTimeIndex> lastEndTimes;
+  std::vector<std::string> typeLabels; // "HC1", "PP1", ... wg procID
+  bool fillGaps = false; // wypełnianie luk na osiach czasu jednostek
+  std::string checkpointPath{}; // migawki stanu w allocateAll
+  int checkpointInterval = 0; // co ile przydzielonych zadań (0 - wcale)
+  int nPathThreads = 1; // wątki computeCriticalPaths (1 - sekwencyjnie)
   int nTasks; // wszystkich w specyfikacji 
   int nPEs; // wszystkich w specyfikacji
   int nChannels;
   std::vector<int> PE_instances_ids;  // [nHC, nPP, nPE_1, nPE_2, ...] //  ile zasobów zosało zaalokowanych do tej pory do każdego z typów. 
    // ten wektor moze wygladac w ten sposob : [2,3,0,20,5,4,6]  czyli 2*HC 3*PP a reszta elementów w wektorze wskazuje 
    // 0 razy użyliśmy HC_1, 20 razy użyliśmy HC_2, 5 razy użyliśmy PP_1 itd.
-   // Naużytek pomocniczego pola label
-  Matrix<double> tasksMatrix;
+   // Na użytek etykiet jednostek (InstanceState::number)
   double overallTime; // całkowity czas
   double overallCost; // całkowity koszt
+  // Składowe overallCost aktualizowane na bieżąco przy każdym przydziale
+  // zadania i podpięciu szyny (patrz accountTask i attachChannel)
+  double peCost; // suma proc[procID][0] po wszystkich zadaniach
+  double taskCost; // suma cost[taskID][procID]
+  double channelCost; // suma po zasobach: (liczba zadań) * (koszt ich szyn)
+  int nAllocatedTasks; // liczba zadań z przydzielonym zasobem
   double t_max; // maksymalny czas
   double c_max; // maksymalny koszt
-  std::vector<double> x_y_z; // wektor współczynników do standaryzacji
+  Coefficients x_y_z; // wektor współczynników do standaryzacji
+  [[no_unique_address]] Scoring scoring;
+  [[no_unique_address]] CoefficientUpdate coefficientUpdate;
+  [[no_unique_address]] ParentSelection parentSelection;
+  // Bufory robocze findBest_timeCost (rozmiar nPEs, alokowane raz)
+  std::vector<double> scratchValues;
+  std::vector<int> scratchProcIDs;
+  CriticalPathEngine criticalPath; // ścieżki krytyczne dla szeregowania zadań
+  AllocationReport* report = nullptr; // wyniki przydziału i szeregowania
+  std::ostream* trace = &std::cerr; // komunikaty diagnostyczne
  public:
-  ResourceAllocator(const Matrix<bool>& tAM, const Matrix<double>& proc_, 
-  const Matrix<double>& times_, const Matrix<double>& cost_,
-  const Matrix<double>& comm, const Matrix<double>& tasks_, 
-  std::vector<bool> utm, double t_max_, double c_max_) : 
-    tasksAdjacencyMatrix{tAM}, proc{proc_}, times{times_}, cost{cost_}, 
-    nTasks{tAM.d1}, nPEs{proc_.d1}, nChannels{comm.d1}, 
-    PE_instances_ids{std::vector<int>(2 + proc.d1)}, tasksMatrix{tasks_}, 
-    overallTime{0}, overallCost{0}, t_max{t_max_}, c_max{c_max_} {
+  // Graf i tabele są przyjmowane przez wartość: wywołujący, który ich już
+  // nie potrzebuje (np. createResourceAllocator), przenosi je std::move bez
+  // kopiowania, a pozostali dostają kopię jak dotąd.
+  BasicResourceAllocator(TaskGraph graph, Matrix<double> proc_, 
+  Matrix<double> times_, Matrix<double> cost_,
+  const Matrix<double>& comm, const std::vector<bool>& utm, double t_max_,
+  double c_max_) : 
+    nTasks{graph.getNumberOfTasks()}, nPEs{proc_.d1}, nChannels{comm.d1}, 
+    PE_instances_ids{std::vector<int>(2 + proc_.d1)}, 
+    overallTime{0}, overallCost{0}, peCost{0}, taskCost{0}, channelCost{0},
+    nAllocatedTasks{0}, t_max{t_max_}, c_max{c_max_} {
+    auto tables = std::make_shared<SpecificationTables>();
+    tables->taskGraph = std::move(graph);
+    tables->proc = std::move(proc_);
+    tables->times = std::move(times_);
+    tables->cost = std::move(cost_);
+    spec = tables;
+    initialise(comm, utm);
+    // Standaryzacja tabel proc, times, cost (każda tabela jest zapisywana
+    // wprost do swojego bufora, bez kopii pośrednich)
+    PerfTimer timer(PHASE_STANDARDISE);
+    standardiseData(tables->proc, true, tables->procStd);
+    standardiseData(tables->times, false, tables->timesStd);
+    standardiseData(tables->cost, false, tables->costStd);
+  }
+  BasicResourceAllocator(CompiledGraph&& g, double t_max_, double c_max_) :
+    // Wczytany plik .tgb ma już wystandaryzowane tabele - tylko je przejmujemy
+    spec{std::make_shared<SpecificationTables>(SpecificationTables{
+      std::move(g.taskGraph), std::move(g.proc), std::move(g.times),
+      std::move(g.cost), std::move(g.procStd), std::move(g.costStd),
+      std::move(g.timesStd)})},
+    nTasks{spec->taskGraph.getNumberOfTasks()},
+    nPEs{spec->proc.d1}, nChannels{g.comm.d1},
+    PE_instances_ids{std::vector<int>(2 + spec->proc.d1)},
+    overallTime{0}, overallCost{0}, peCost{0}, taskCost{0}, channelCost{0},
+    nAllocatedTasks{0}, t_max{t_max_}, c_max{c_max_} {
+    initialise(g.comm, g.unpredictedTasksMask);
+  }
+  ~BasicResourceAllocator() {}
+
+  void initialise(const Matrix<double>& comm, const std::vector<bool>& utm) {
+    // Wspólna część konstruktorów: zadania, szyny, liczniki typów PE i
+    // początkowe współczynniki
     for (int i = 0; i < nTasks; ++i)
-      tasks.push_back(Task(i, utm[i]));
+      tasks.add(utm[i]);
     for (int i = 0; i < nChannels; ++i) {
       channels.push_back(Channel(comm[i][0], comm[i][1], 
         std::vector<bool>(nPEs), i));
       for (int j = 0; j < nPEs; ++j)
         channels[i].connections[j] = comm[i][2 + j];
     }
+    channelIndex.build(channels, nPEs);
+    instanceChannels.build(channelIndex);
+    instancesOfType.resize(nPEs);
+    lastEndTimes.resize(nPEs);
     for (int i = 0; i < nPEs; ++i)
-      if (proc[i][2] == 0)
+      if (spec->proc[i][2] == 0)
         PE_instances_ids[0]++;
       else
         PE_instances_ids[1]++;
-    // Standaryzacja tabel proc, times, cost
-    procStd = standardiseData(proc, true);
-    timesStd = standardiseData(times, false);
-    costStd = standardiseData(cost, false);
+    // Etykieta typu, np. "HC2" albo "PP1" (numeracja w obrębie zasobów
+    // sprzętowych / uniwersalnych w kolejności z @proc)
+    for (int i = 0; i < nPEs; ++i) {
+      int PE_type_count = 1;
+      for (int j = 0; j < i; ++j)
+        if (spec->proc[j][2] == spec->proc[i][2]) PE_type_count++;
+      typeLabels.push_back((spec->proc[i][2] == 0 ? "HC" : "PP") +
+                           std::to_string(PE_type_count));
+    }
     // Początkowe ustawienie współczynników
-    for (int c = 0; c < 3; c++)
-      x_y_z.push_back(1.0/3);     
+    x_y_z.fill(1.0/3);
+    scratchValues.reserve(nPEs);
+    scratchProcIDs.reserve(nPEs);
   }
-  ~ResourceAllocator() {}
   
-  std::vector<int> findAllParents(int taskID) {
+  SpecificationTables& mutableSpec() {
+    // Dane specyfikacji do zmiany: współdzielone z innymi kopiami alokatora
+    // są najpierw kopiowane
+    if (spec.use_count() != 1)
+      spec = std::make_shared<SpecificationTables>(*spec);
+    return const_cast<SpecificationTables&>(*spec);
+  }
+
+  std::span<const int> findAllParents(int taskID) {
     // Znajduje wszystkich rodziców (bezpośrednich poprzedników rozważanego
-    // zadania o numerze TaskID). Zwraca wektor zawierający numery tych zadań.
-    std::vector<int> results{};
-    for (int i = 0; i < nTasks; ++i)
-      if (tasksAdjacencyMatrix[i][taskID])
-        results.push_back(i);
-    return results;
+    // zadania o numerze TaskID). Zwraca widok na listę numerów tych zadań
+    // (rosnąco) zbudowaną wcześniej w TaskGraph.
+    perfCount(PERF_FIND_ALL_PARENTS);
+    return spec->taskGraph.parents(taskID);
   }
 
   int findBest_std(int taskID) {
-    // Sprawdź jakie zasoby ze wszystkich da się podpiąć do rodzica
-    std::vector<int> resourcesThatCanBeUsed{};
-    for (int i = 0; i < nPEs; ++i)
-      if (canBeConnectedToBestParent(taskID, i))
-        resourcesThatCanBeUsed.push_back(i);
-    // Liczenie wartości zgodnie ze wzorem ComputeUsingStd
-    std::vector<double> overallValues{};
-    for (auto e : resourcesThatCanBeUsed)
-      overallValues.push_back(computeUsingStd(procStd[e][0], costStd[taskID][e],
-        timesStd[taskID][e], x_y_z[0], x_y_z[1], x_y_z[2]));
-    // Znalezienie najlepszego zasobu
-    int bestResourceID = resourcesThatCanBeUsed[0];
-    double minValue = overallValues[0]; // tu znajdujemy wartosc minimalną (x*p + y*c + z*t) obliczaną z computeUsingStd (powyżej)
-    for (int i = 0; i < (int)overallValues.size(); ++i) {
-      if (overallValues[i] < minValue) {
-        minValue = overallValues[i];
-        bestResourceID = resourcesThatCanBeUsed[i];
+    perfCount(PERF_FIND_BEST_STD);
+    // Wśród zasobów, które da się podpiąć do rodzica, szukamy minimum
+    // oceny Scoring::standardised (domyślnie wzór ComputeUsingStd,
+    // x*p + y*c + z*t) - w jednym przejściu, bez pomocniczych list. Przy
+    // remisie wygrywa pierwszy zasób.
+    int bestResourceID = -1;
+    double minValue = 0;
+    for (int i = 0; i < nPEs; ++i) {
+      if (!canBeConnectedToBestParent(taskID, i))
+        continue;
+      double value = scoring.standardised(spec->procStd[i][0], spec->costStd[taskID][i],
+                                          spec->timesStd[taskID][i], x_y_z);
+      if (bestResourceID == -1 || value < minValue) {
+        minValue = value;
+        bestResourceID = i;
       }
     }
     return bestResourceID;
   }
 
   void updateCoefficients() {
-    // Aktualizuje współczynniki i normalizuje je za pomocą Softmax
-    // Wyliczenie liczby zadań, które nie mają przydzielonych zasobów
-    double n = 0;
-    for (int t = 0; t < nTasks; ++t)
-      if (tasks[t].resourceID != -1)
-        n++;
-    // Liczenie "masy"
-    auto m = 1 + n / nTasks;
-    // Liczenie wektora prędkości
-    auto v_proc_cost = overallCost / c_max - overallTime / t_max;
-    auto v_times = overallTime / t_max - overallCost / c_max;
-    // Liczenie wektora pędu
-    auto p_proc_cost = m * v_proc_cost;
-    auto p_times = m * v_times;
-    // Przeliczenie współczynników
-    std::cerr << "ResourceAllocator::updateCoefficients: Updating " 
-              << "the coefficients\n";
-    std::cerr << "  Old values: " << x_y_z[0] << " " << x_y_z[1] << " " 
-              << x_y_z[2] << '\n';
-    auto new_coeffs = softmax(x_y_z[0] + p_proc_cost, x_y_z[1] + p_proc_cost,
-      x_y_z[2] + p_times);
-    x_y_z = new_coeffs;
-    std::cerr << "  New values: " << x_y_z[0] << " " << x_y_z[1] << " "
-              << x_y_z[2] << '\n';
+    // Aktualizuje współczynniki według CoefficientUpdate (domyślnie pęd i
+    // normalizacja Softmax)
+    perfCount(PERF_UPDATE_COEFFICIENTS);
+    LOG_AT(LOG_TRACE) {
+      *trace << "ResourceAllocator::updateCoefficients: Updating " 
+                << "the coefficients\n";
+      *trace << "  Old values: " << x_y_z[0] << " " << x_y_z[1] << " " 
+                << x_y_z[2] << '\n';
+    }
+    coefficientUpdate.update(x_y_z, AllocationProgress{nAllocatedTasks, nTasks,
+      overallTime, overallCost, t_max, c_max});
+    LOG_AT(LOG_TRACE)
+      *trace << "  New values: " << x_y_z[0] << " " << x_y_z[1] << " "
+                << x_y_z[2] << '\n';
   }
 
   int findBestParent(int taskID) {
-    // Znajduje rodzica, który kończy się wykonywać najwcześniej, więc
-    // jest poprzednikiem, który dla dziecka wyznacza ścieżkę
+    // Znajduje poprzednika, który dla dziecka wyznacza ścieżkę (wybór według
+    // ParentSelection, domyślnie rodzic kończący się najwcześniej)
+    perfCount(PERF_FIND_BEST_PARENT);
     auto allParentsIDs = findAllParents(taskID);
     if (allParentsIDs.size() == 0)
       return -1;
-    int bestParentID = allParentsIDs[0];
-    double minEndTime = resources[tasks[bestParentID].resourceID].lastTaskEndTime;
-    for (auto parentID : allParentsIDs) {
-      double endTime = resources[tasks[parentID].resourceID].lastTaskEndTime;
-      if (endTime < minEndTime) {
-        bestParentID = parentID;
-        minEndTime = endTime;
-      }
-    }
-    return bestParentID;
+    return parentSelection.select(allParentsIDs,
+                                  [this](int parentID) {
+                                    return finishTime(parentID);
+                                  });
+  }
+
+  double finishTime(int taskID) {
+    // Koniec wykonania zadania z przydzielonym zasobem. Bez wypełniania luk
+    // (jak dotąd) jest to koniec ostatniego zadania na tej samej jednostce -
+    // zadania trafiają tam po kolei, więc nie jest to wcześniej niż koniec
+    // samego taskID.
+    if (fillGaps)
+      return tasks.endTime[taskID];
+    return instances.lastTaskEndTime[tasks.resourceID[taskID]];
   }
 
   int findBestChannel(int parentID, int childID) {
+    return findBestChannelForType(parentID,
+                                  instances.procID[tasks.resourceID[childID]]);
+  }
+
+  int findBestChannelForType(int parentID, int childProcID) {
     // Znalezienie nalepszej szyny danych, czyli takiej, która zapewnia
     // łączność między poprzednikiem a następnikiem. Najpierw sprawdzamy czy
     // poprzednik już nie był wcześniej podpięty do którejś z szyn spełniających
@@ -152,60 +257,20 @@ class ResourceAllocator {
     // to podpinamy zarówno rodzica jak i dziecko do nowej szyny danych. Nowa
     // szyna danych wybierana jest wśród dostępnych i spełniających wymogi na
     // podstawie kosztu podpięcia (interesuje nas najmniejszy koszt podpięcia)
-    if (parentID == -1) {
-      int channID;
-      for (auto channel : channels)
-        if (channel.connections[resources[tasks[childID].resourceID].procID])
-          channID = channel.id;
-      double minCost = channels[channID].cost;
-      for (auto channel : channels)
-        if (channel.cost < minCost) {
-          channID = channel.id;
-          minCost = channel.cost;
-        }
-      return channID;
-    } else {
-      int parentProcID = resources[tasks[parentID].resourceID].procID;
-      int childProcID = resources[tasks[childID].resourceID].procID;
-      // Checking all the channels to which the parent has already been connected
-      int choice = -1;
-      for (auto channelID : resources[tasks[parentID].resourceID].channelIDs)
-        if (channels[channelID].connections[childProcID])
-          choice = channelID;
-      int firstAvailableForChild;
-      for (auto channel : channels)
-        if (channel.connections[childProcID])
-          firstAvailableForChild = channel.id;
-      double minimum = 
-        channels[choice != -1 ? choice : firstAvailableForChild].cost;
-      for (auto channelID : resources[tasks[parentID].resourceID].channelIDs)
-        if (channels[channelID].connections[childProcID] &&
-          channels[channelID].cost < minimum) {
-            minimum = channels[channelID].cost;
-            choice = channelID;
-          }
-      if (choice != -1)
-        return choice;
-      // Checking all the channels
-      int firstAvailableChannel;
-      for (auto channel : channels) {
-        auto connections = channel.connections;
-        if (connections[parentProcID] && connections[childProcID])
-          firstAvailableChannel = channel.id;
-      }
-      int idealChannel = firstAvailableChannel;
-      // Wybór najtańszego z punktu widzenia dostępnych
-      double minCost = channels[idealChannel].cost;
-      for (auto channel : channels) {
-        auto connections = channel.connections;
-        if (connections[parentProcID] && connections[childProcID] &&
-        channel.cost < minCost) {
-          minCost = channel.cost;
-          idealChannel = channel.id;
-        }
-      }
-      return idealChannel;
-    }
+    // Odpowiedzi dla par typów PE są w channelIndex, a szyny już podpięte do
+    // rodzica w instanceChannels, więc wybór odbywa się w czasie stałym.
+    perfCount(PERF_FIND_BEST_CHANNEL);
+    if (parentID == -1)
+      return channelIndex.rootChannel(childProcID);
+    int parentResourceID = tasks.resourceID[parentID];
+    // Checking all the channels to which the parent has already been connected
+    int choice = instanceChannels.bestChannelTo(parentResourceID, childProcID,
+                                                channels);
+    if (choice != -1)
+      return choice;
+    // Checking all the channels
+    return channelIndex.sharedChannel(instances.procID[parentResourceID],
+                                      childProcID);
   }
 
   bool allParentsHaveResources(int taskID) {
@@ -216,7 +281,7 @@ class ResourceAllocator {
     // przydzielić, żeby móc wyznaczyć czas i, co najważniejsze, szynę danych)
     auto parentsIDs = findAllParents(taskID);
     for (auto parentID : parentsIDs)
-      if (tasks[parentID].resourceID == -1)
+      if (tasks.resourceID[parentID] == -1)
         return false;
     return true;
   }
@@ -228,261 +293,842 @@ class ResourceAllocator {
     if (nParents == 0)
       return true;
     int parentID = findBestParent(taskID);
-    if (tasks[parentID].resourceID == -1)
+    if (tasks.resourceID[parentID] == -1)
       throw std::invalid_argument("Parent T" + std::to_string(parentID)
         + " does not have any resource allocated");
-    int parentResourceProcID = resources[tasks[parentID].resourceID].procID;
-    bool specificParentConnection = false;
-    for (auto channel : channels) {
-      auto connections = channel.connections;
-      if (connections[parentResourceProcID] && connections[procID]) {
-        std::cerr << "ResourceAllocator::canBeConnectedToBestParent()\n" 
-          << "  Connection between the parent PE (" << parentResourceProcID
-          << ") and the current task (" << taskID << ") PE (" << procID
-          << ") is possible on " << channel.id << '\n';  
-        specificParentConnection = true;
-        break;
-      }
-    }
-    if (!specificParentConnection)
+    int parentResourceProcID = instances.procID[tasks.resourceID[parentID]];
+    int channelID = channelIndex.firstSharedChannel(parentResourceProcID, procID);
+    if (channelID == -1)
       return false;
+    LOG_AT(LOG_TRACE)
+      *trace << "ResourceAllocator::canBeConnectedToBestParent()\n" 
+        << "  Connection between the parent PE (" << parentResourceProcID
+        << ") and the current task (" << taskID << ") PE (" << procID
+        << ") is possible on " << channelID << '\n';  
     return true;
   }
 
   void recomputeAllPathsTime() {
     // Przeliczenie (aktualizacja odpowiednich pól) i wypisanie na wyjściu 
     for (int t = 0; t < nTasks; ++t) {
-      auto resource = resources[tasks[t].resourceID];
-      std::cerr << "Recomputing time for " << resource.label << '\n';
+      int r = tasks.resourceID[t];
+      LOG_AT(LOG_TRACE)
+        *trace << "Recomputing time for " << label(r) << '\n';
       int bestParentID = findBestParent(t);
-      std::cerr << "Best parent for T" << t << " is " << bestParentID << '\n';
+      LOG_AT(LOG_TRACE)
+        *trace << "Best parent for T" << t << " is " << bestParentID << '\n';
       if (bestParentID != -1) {
-        if (tasks[t].resourceID != tasks[bestParentID].resourceID) {
-          auto taskChannelIDs = resource.channelIDs;
-          auto parentChannelIDs = 
-            resources[tasks[bestParentID].resourceID].channelIDs;
+        int parentR = tasks.resourceID[bestParentID];
+        if (r != parentR) {
           int channelChoice = -1;
           
-          std::cerr << "T" << t << " channels:\n";
-          for (auto channel : resources[tasks[t].resourceID].channelIDs)
-            std::cerr << channel << ' ';
-          std::cerr << '\n';
-          std::cerr << "T" << bestParentID << " (parent) channels:\n";
-          for (auto channel : resources[tasks[bestParentID].resourceID].channelIDs)
-            std::cerr << channel << ' ';
-          std::cerr << '\n';
-
-          for (auto task : taskChannelIDs) {
-            if (std::find(parentChannelIDs.begin(), parentChannelIDs.end(), task)
-              != parentChannelIDs.end())
-              channelChoice = task;
+          LOG_AT(LOG_TRACE) {
+            *trace << "T" << t << " channels:\n";
+            for (auto channel : instances.channelIDs[r])
+              *trace << channel << ' ';
+            *trace << '\n';
+            *trace << "T" << bestParentID << " (parent) channels:\n";
+            for (auto channel : instances.channelIDs[parentR])
+              *trace << channel << ' ';
+            *trace << '\n';
+          }
+
+          for (auto channel : instances.channelIDs[r]) {
+            if (instanceChannels.contains(parentR, channel))
+              channelChoice = channel;
           }
           // Best parent can be changed, so we need to make sure the parent can 
           // be connected to its new child
           if (channelChoice == -1) {
             int channel = findBestChannel(bestParentID, t);
-            // std::cerr << "FindBestChannel for parent T" << bestParentID  << " and"
-              // << " child T" << t << " : " << channel << '\n';
-            if (std::find(taskChannelIDs.begin(), taskChannelIDs.end(), channel)
-              == taskChannelIDs.end())
-              resources[tasks[t].resourceID].channelIDs.push_back(channel);
-            if (std::find(parentChannelIDs.begin(), parentChannelIDs.end(),
-                          channel) == parentChannelIDs.end())
-              resources[tasks[bestParentID].resourceID].channelIDs.push_back(channel);
+            if (!instanceChannels.contains(r, channel))
+              attachChannel(r, channel);
+            if (!instanceChannels.contains(parentR, channel))
+              attachChannel(parentR, channel);
             channelChoice = channel;
           }
-          std::cerr << channelChoice << '\n';
+          LOG_AT(LOG_TRACE) *trace << channelChoice << '\n';
 
+          // Szyna podpięta przed chwilą to channelChoice, więc nie zmienia
+          // wyniku szukania tańszej szyny wspólnej
           int minCost = channels[channelChoice].cost;
-          for (auto channel : taskChannelIDs) {
-            std::cerr << "T" << t << " has parent T"
+          for (auto channel : instances.channelIDs[r]) {
+            LOG_AT(LOG_TRACE) *trace << "T" << t << " has parent T"
                       << bestParentID << " [channel " << channel << "]\n";
-            if (std::find(parentChannelIDs.begin(), parentChannelIDs.end(),
-                          channel) != parentChannelIDs.end() &&
+            if (instanceChannels.contains(parentR, channel) &&
                 channels[channel].cost < minCost) {
               channelChoice = channel;
             }
           }
-          resources[tasks[t].resourceID].lastTaskStartTime = 
-            resources[tasks[bestParentID].resourceID].lastTaskEndTime 
-            + tasksMatrix[bestParentID][t] / channels[channelChoice].bandwidth;
+          instances.lastTaskStartTime[r] = instances.lastTaskEndTime[parentR]
+            + spec->taskGraph.weight(bestParentID, t) / channels[channelChoice].bandwidth;
+        }
+        instances.lastTaskEndTime[r] = instances.lastTaskStartTime[r] +
+          spec->times[t][instances.procID[r]];
+        LOG_AT(LOG_TRACE) {
+          *trace << "T" << t << " startTime "
+                    << instances.lastTaskStartTime[r] << '\n';
+          *trace << "T" << t << " endTime "
+                    << instances.lastTaskEndTime[r] << '\n';
         }
-        resources[tasks[t].resourceID].lastTaskEndTime = 
-          resources[tasks[t].resourceID].lastTaskStartTime +
-          times[t][resources[tasks[t].resourceID].procID];
-        std::cerr << "T" << t << " startTime "
-                  << resources[tasks[t].resourceID].lastTaskStartTime << '\n';
-        std::cerr << "T" << t << " endTime "
-                  << resources[tasks[t].resourceID].lastTaskEndTime << '\n';
       } else {
-        resources[tasks[t].resourceID].lastTaskStartTime = 0;
-        resources[tasks[t].resourceID].lastTaskEndTime =
-            resources[tasks[t].resourceID].lastTaskStartTime + times[t][
-              resources[tasks[t].resourceID].procID];
+        instances.lastTaskStartTime[r] = 0;
+        instances.lastTaskEndTime[r] = instances.lastTaskStartTime[r] +
+          spec->times[t][instances.procID[r]];
       }
+      lastEndTimes[instances.procID[r]].set(instances.number[r],
+                                            instances.lastTaskEndTime[r]);
     }
-    std::cout << "Time intervals have been recomputed:\n";
     for (int t = 0; t < nTasks; ++t) {
-      std::cout << "  T" << t << " -> " << resources[tasks[t].resourceID].label
-                << " [startTime: "
-                << resources[tasks[t].resourceID].lastTaskStartTime
-                << ", endTime: "
-                << resources[tasks[t].resourceID].lastTaskEndTime << "]\n";
+      int r = tasks.resourceID[t];
+      record(RECORD_RECOMPUTED, t, instances.procID[r], instances.number[r],
+             instances.lastTaskStartTime[r], instances.lastTaskEndTime[r]);
     }
   }
 
   void recomputeOverallTimeAndCost() {
-    // Przeliczenie całkowitego kosztu i czasu (aktualizacja pól prywatnych
-    // overallTime i overallCost)
+    // Pełne przeliczenie całkowitego kosztu i czasu (aktualizacja pól
+    // prywatnych overallTime i overallCost oraz ich składowych). Potrzebne
+    // tylko wtedy, gdy czasy zasobów zmieniają się poza allocate (np.
+    // recomputeAllPathsTime) - allocate liczy je przyrostowo.
     overallTime = 0;
-    for (auto task : tasks)
-      if (task.resourceID != -1 && resources[task.resourceID].lastTaskEndTime >
-          overallTime)
-        overallTime = resources[task.resourceID].lastTaskEndTime;
-    overallCost = 0;
-    for (auto task : tasks) {
-      int id = task.resourceID;
+    for (auto id : tasks.resourceID)
+      if (id != -1 && instances.lastTaskEndTime[id] > overallTime)
+        overallTime = instances.lastTaskEndTime[id];
+    peCost = 0;
+    taskCost = 0;
+    channelCost = 0;
+    nAllocatedTasks = 0;
+    for (int r = 0; r < instances.size(); ++r) {
+      instances.totalNumOfJobs[r] = 0;
+      instances.channelsCost[r] = 0;
+      for (auto channelID : instances.channelIDs[r])
+        instances.channelsCost[r] += channels[channelID].cost;
+    }
+    for (int t = 0; t < tasks.size(); ++t) {
+      int id = tasks.resourceID[t];
       if (id != -1) {
-        overallCost += proc[resources[id].procID][0];
-        overallCost += cost[task.id][resources[id].procID];
-        for (auto channelID : resources[id].channelIDs)
-          overallCost += channels[channelID].cost;
+        peCost += spec->proc[instances.procID[id]][0];
+        taskCost += spec->cost[t][instances.procID[id]];
+        for (auto channelID : instances.channelIDs[id])
+          channelCost += channels[channelID].cost;
+        instances.totalNumOfJobs[id]++;
+        nAllocatedTasks++;
       }
     } 
+    overallCost = peCost + taskCost + channelCost;
   }
 
-  void allocate(int taskID) {
-    // Alokuje zasób najlepszy z punktu widzenia findBest_std(taskID)
-    if (tasks[taskID].resourceID == -1) {
-      // Recursive bound
-      if (allParentsHaveResources(taskID)) {
-        std::cerr << "ResourceAllocator::allocate(): Allocating resources for T" 
-          << taskID << '\n';
-        // Updating the coefficients
-        updateCoefficients();
-        // Resource allocation
-        int procID = findBest_std(taskID);
-        // Sprawdzenie dostępności wybranego zasobu wśród już zaalokowanych
-        int allParents = findAllParents(taskID).size();
-        int bestParentID = allParents == 0 ? -1 : findBestParent(taskID);
-        double bestParentEndTime = bestParentID == - 1 ? 0 : 
-          resources[tasks[bestParentID].resourceID].lastTaskEndTime;
-        bool useAvailablePE = false;
-        for (int i = 0; i < (int)resources.size(); ++i) {
-          auto r = resources[i];
-          if (r.procID == procID)
-            if ((bestParentEndTime == 0 && r.lastTaskEndTime == 0) || 
-            (bestParentEndTime > 0 && bestParentEndTime > r.lastTaskEndTime)) {
-              tasks[taskID].resourceID = i;
-              useAvailablePE = true;
-            }
+  void attachChannel(int resourceID, int channelID) {
+    // Podpina zasób do szyny. Koszt szyny liczony jest raz dla każdego
+    // zadania na tym zasobie, więc channelCost rośnie o (liczba zadań) * koszt.
+    instances.channelIDs.push(resourceID, channelID);
+    instanceChannels.add(resourceID, channelID, channels[channelID].cost,
+                         channelIndex);
+    instances.channelsCost[resourceID] += channels[channelID].cost;
+    channelCost += instances.totalNumOfJobs[resourceID] *
+                   channels[channelID].cost;
+    overallCost = peCost + taskCost + channelCost;
+  }
+
+  void accountTask(int taskID) {
+    // Dolicza właśnie przydzielone zadanie do całkowitego czasu i kosztu w
+    // czasie O(1). Czas zakończenia zadań na danym zasobie tylko rośnie, więc
+    // całkowity czas to maksimum z czasów zakończenia kolejnych zadań.
+    int r = tasks.resourceID[taskID];
+    peCost += spec->proc[instances.procID[r]][0];
+    taskCost += spec->cost[taskID][instances.procID[r]];
+    channelCost += instances.channelsCost[r];
+    instances.totalNumOfJobs[r]++;
+    nAllocatedTasks++;
+    if (instances.lastTaskEndTime[r] > overallTime)
+      overallTime = instances.lastTaskEndTime[r];
+    overallCost = peCost + taskCost + channelCost;
+#ifndef NDEBUG
+    checkOverallTimeAndCost();
+#endif
+  }
+
+  void checkOverallTimeAndCost() {
+    // Kontrola spójności (tylko w wersji debug): porównanie sum liczonych
+    // przyrostowo z pełnym przeliczeniem.
+    double time = overallTime;
+    double total = overallCost;
+    recomputeOverallTimeAndCost();
+    if (time != overallTime ||
+        std::abs(total - overallCost) > 1e-9 * std::max(1.0, overallCost))
+      throw std::logic_error("Incremental overall time/cost (" +
+        std::to_string(time) + ", " + std::to_string(total) +
+        ") differs from full recomputation (" + std::to_string(overallTime) +
+        ", " + std::to_string(overallCost) + ")");
+  }
+
+  template<typename Visit>
+  void visitInAllocationOrder(int taskID, std::vector<char>& state,
+                              std::vector<std::pair<int, int>>& stack,
+                              Visit visit) {
+    // Przechodzi nieprzydzielonych przodków zadania taskID (i samo zadanie) w
+    // tej samej kolejności, w jakiej robiło to rekurencyjne allocate:
+    // najpierw rodzice rosnąco po ID (każdy razem ze swoimi przodkami), potem
+    // zadanie. Stos jest jawny (na stercie), więc głęboki łańcuch zadań nie
+    // przepełni stosu wywołań; wywołujący podaje go z zewnątrz, żeby kolejne
+    // wywołania używały tego samego bufora. state: 0 - nieodwiedzone, 1 - na
+    // stosie, 2 - przetworzone.
+    if (state[taskID] != 0 || tasks.resourceID[taskID] != -1)
+      return;
+    stack.assign(1, {taskID, 0});
+    state[taskID] = 1;
+    while (!stack.empty()) {
+      auto& [t, next] = stack.back();
+      auto parents = spec->taskGraph.parents(t);
+      if (next < (int)parents.size()) {
+        int parentID = parents[next++];
+        if (state[parentID] == 1)
+          throw std::invalid_argument("Task graph contains a cycle");
+        if (state[parentID] == 0 && tasks.resourceID[parentID] == -1) {
+          state[parentID] = 1;
+          stack.emplace_back(parentID, 0);
         }
-        std::string resourceLabel;
-        if (useAvailablePE) {
-          resourceLabel = resources[tasks[taskID].resourceID].label;
-          std::cerr << "Available " << resources[tasks[taskID].resourceID].label
-            << " will be used for " << "T" << taskID << '\n';
-        } else {
-          resourceLabel = "undefined_label";
-          if (proc[procID][2] == 0)
-            resourceLabel = "HC";
-          else
-            resourceLabel = "PP";
-          int PE_type_count = 1;
-          for (int i = 0; i < procID; ++i)
-            if (proc[i][2] == proc[procID][2]) PE_type_count++;
-          resourceLabel += std::to_string(PE_type_count) + "_" +
-            std::to_string(PE_instances_ids[2 + procID]++);
-          resources.push_back(PE(procID, resourceLabel));
-          tasks[taskID].resourceID = resources.size() - 1;
+      } else {
+        state[t] = 2;
+        int finished = t;
+        stack.pop_back();
+        visit(finished);
+      }
+    }
+  }
+
+  std::vector<int> allocationOrder() {
+    // Porządek topologiczny, w którym allocateAll przydziela zadania - ten
+    // sam, który dawały kolejne wywołania allocate(0), allocate(1), ...
+    std::vector<int> order{};
+    order.reserve(nTasks);
+    std::vector<char> state(nTasks, 0);
+    std::vector<std::pair<int, int>> stack{};
+    for (int t = 0; t < nTasks; ++t)
+      visitInAllocationOrder(t, state, stack,
+                             [&order](int taskID) { order.push_back(taskID); });
+    return order;
+  }
+
+  void allocateTask(int taskID) {
+    // Przydziela zasób najlepszy z punktu widzenia findBest_std(taskID).
+    // Wszyscy rodzice zadania muszą już mieć zasoby.
+    perfCount(PERF_ALLOCATED_TASKS);
+    if (taskID >= spec->timesStd.d1)
+      throw std::logic_error("T" + std::to_string(taskID) + " was inserted "
+        "online and has no standardised data");
+    LOG_AT(LOG_INFO)
+      *trace << "ResourceAllocator::allocate(): Allocating resources for T" 
+        << taskID << '\n';
+    // Updating the coefficients
+    updateCoefficients();
+    // Resource allocation
+    int procID = findBest_std(taskID);
+    int allParents = findAllParents(taskID).size();
+    int bestParentID = allParents == 0 ? -1 : findBestParent(taskID);
+    placeTask(taskID, procID, bestParentID);
+  }
+
+  void placeTask(int taskID, int procID, int bestParentID) {
+    // Umieszcza zadanie na jednostce typu procID (już istniejącej albo
+    // nowej), podpina szyny do rodzica bestParentID i dolicza czas i koszt.
+    // Sprawdzenie dostępności wybranego zasobu wśród już zaalokowanych
+    double bestParentEndTime = bestParentID == - 1 ? 0 : 
+      finishTime(bestParentID);
+    // Szyna zależy tylko od typu PE dziecka i szyn jednostki rodzica, więc
+    // opóźnienie transmisji znamy przed wyborem jednostki
+    int channelID = findBestChannelForType(bestParentID, procID);
+    int parentResourceID = bestParentID == -1 ? -1 :
+      tasks.resourceID[bestParentID];
+    double transferTime = bestParentID == -1 ? 0 :
+      spec->taskGraph.weight(bestParentID, taskID) / channels[channelID].bandwidth;
+    bool useAvailablePE = false;
+    double gapStart = 0;
+    if (fillGaps) {
+      // Jednostka jest używana ponownie, jeśli ma wolną przerwę, w której
+      // zadanie zmieści się bez opóźnienia względem rodzica albo nie
+      // wydłużając dotychczasowego czasu całkowitego. Spośród takich
+      // wygrywa najwcześniejszy start (przy remisie ostatnia jednostka).
+      double duration = spec->times[taskID][procID];
+      for (auto i : instancesOfType[procID]) {
+        double ready = bestParentEndTime +
+                       (i == parentResourceID ? 0 : transferTime);
+        double start = instances.timeline[i].earliestStart(ready, duration);
+        if ((start == ready || start + duration <= overallTime) &&
+            (!useAvailablePE || start <= gapStart)) {
+          tasks.resourceID[taskID] = i;
+          useAvailablePE = true;
+          gapStart = start;
         }
+      }
+    } else {
+      // Ostatnia jednostka typu procID, której ostatnie zadanie kończy się
+      // przed końcem rodzica (bez rodzica: jednostka z końcem 0 - czasy są
+      // nieujemne, więc to to samo co koniec <= 0)
+      int position = bestParentEndTime > 0 ?
+        lastEndTimes[procID].lastBefore(bestParentEndTime, false) :
+        bestParentEndTime == 0 ? lastEndTimes[procID].lastBefore(0, true) : -1;
+      if (position != -1) {
+        tasks.resourceID[taskID] = instancesOfType[procID][position];
+        useAvailablePE = true;
+      }
+    }
+    if (useAvailablePE) {
+      LOG_AT(LOG_INFO)
+        *trace << "Available " << label(tasks.resourceID[taskID])
+          << " will be used for " << "T" << taskID << '\n';
+    } else {
+      int r = instances.add(procID, PE_instances_ids[2 + procID]++);
+      instanceChannels.addInstance();
+      instancesOfType[procID].push_back(r);
+      lastEndTimes[procID].push(instances.lastTaskEndTime[r]);
+      tasks.resourceID[taskID] = r;
+    }
 
-        int channelID;
-        double startTime;
-        bool sameResource =
-            tasks[bestParentID].resourceID == tasks[taskID].resourceID;
-        if (bestParentID == -1) {
-          channelID = findBestChannel(-1, taskID);
-          startTime = 0;
-        } else {
-          channelID = findBestChannel(bestParentID, taskID);
-          startTime = (sameResource ? 0 : (tasksMatrix[bestParentID][taskID] /
-                       channels[channelID].bandwidth)) +
-                      resources[tasks[bestParentID].resourceID].lastTaskEndTime;
-          if (!sameResource) {
-            auto parentChannels =
-                resources[tasks[bestParentID].resourceID].channelIDs;
-            if (std::find(parentChannels.begin(), parentChannels.end(),
-                          channelID) == parentChannels.end())
-              resources[tasks[bestParentID].resourceID].channelIDs.push_back(
-                  channelID);
-          }
+    double startTime = 0;
+    if (bestParentID != -1) {
+      bool sameResource = parentResourceID == tasks.resourceID[taskID];
+      startTime = (sameResource ? 0 : transferTime) + bestParentEndTime;
+      if (!sameResource) {
+        if (!instanceChannels.contains(parentResourceID, channelID))
+          attachChannel(parentResourceID, channelID);
+      }
+    }
+    if (fillGaps && useAvailablePE)
+      startTime = gapStart;
+    
+    if (!useAvailablePE)
+      attachChannel(tasks.resourceID[taskID], channelID);
+    double endTime = startTime + spec->times[taskID][procID];
+    int r = tasks.resourceID[taskID];
+    tasks.startTime[taskID] = startTime;
+    tasks.endTime[taskID] = endTime;
+    if (fillGaps)
+      instances.timeline[r].reserve(startTime, spec->times[taskID][procID]);
+    if (!fillGaps || endTime >= instances.lastTaskEndTime[r]) {
+      instances.lastTaskStartTime[r] = startTime;
+      instances.lastTaskEndTime[r] = endTime;
+      lastEndTimes[procID].set(instances.number[r], endTime);
+    }
+    record(RECORD_ALLOCATED, taskID, procID, instances.number[r], startTime,
+           endTime);
+    LOG_AT(LOG_DEBUG) {
+      if (taskID == nTasks - 1) {
+        *trace << '\n';
+        for (int tID = 0; tID < nTasks; ++tID) {
+          // Przy ID niezgodnych z porządkiem topologicznym część zadań może
+          // jeszcze nie mieć zasobu
+          if (tasks.resourceID[tID] == -1)
+            continue;
+          *trace << "ResourceAllocator::allocate:\n  T" << tID
+                    << " resource is connected to channels: ";
+          for (auto cID : instances.channelIDs[tasks.resourceID[tID]])
+            *trace << cID << " ";
+          *trace << '\n';
         }
-        
-        if (!useAvailablePE)
-          resources[tasks[taskID].resourceID].channelIDs.push_back(channelID);
-        double endTime = startTime + times[taskID][procID];
-        resources[tasks[taskID].resourceID].lastTaskStartTime = startTime;
-        resources[tasks[taskID].resourceID].lastTaskEndTime = endTime;
-        std::cout << "  T" << taskID << " --> "
-                  << resources[tasks[taskID].resourceID].label
-                  << " [startTime: " << startTime << ", endTime: " << endTime
-                  << "]\n";
-        if (taskID == nTasks - 1) {
-          std::cerr << '\n';
-          for (int tID = 0; tID < nTasks; ++tID) {
-            std::cerr << "ResourceAllocator::allocate:\n  T" << tID
-                      << " resource is connected to channels: ";
-            for (auto cID : resources[tasks[tID].resourceID].channelIDs)
-              std::cerr << cID << " ";
-            std::cerr << '\n';
-          }
-          std::cerr << '\n';
+        *trace << '\n';
+      }
+    }
+    // Updating the overall time and cost
+    accountTask(taskID);
+  }
+
+  void allocate(int taskID) {
+    // Alokuje zasób dla zadania taskID, a wcześniej (jeśli trzeba) dla jego
+    // nieprzydzielonych przodków
+    if (tasks.resourceID[taskID] != -1)
+      return;
+    if (allParentsHaveResources(taskID)) {
+      allocateTask(taskID);
+      return;
+    }
+    std::vector<char> state(nTasks, 0);
+    std::vector<std::pair<int, int>> stack{};
+    visitInAllocationOrder(taskID, state, stack,
+                           [this](int t) { allocateTask(t); });
+  }
+
+  void allocateAll() {
+    // Algorytm konstrukcyjny dla całego grafu: porządek topologiczny jest
+    // wyznaczany raz, a zadania są przydzielane po kolei bez rekurencji
+    PerfTimer timer(PHASE_ALLOCATE);
+    std::uint64_t hash = checkpointInterval > 0 ? tablesHash() : 0;
+    for (auto taskID : allocationOrder())
+      if (tasks.resourceID[taskID] == -1) {
+        allocateTask(taskID);
+        if (checkpointInterval > 0 &&
+            nAllocatedTasks % checkpointInterval == 0 &&
+            saveCheckpoint(checkpointPath, hash) == -1)
+          checkpointInterval = 0;
+      }
+    LOG_AT(LOG_INFO)
+      *trace << "ResourceAllocator::allocateAll(): " << instances.size()
+        << " PE instances\n";
+  }
+
+  std::uint64_t tablesHash() const {
+    // Skrót tabel proc, times i cost - migawka pasuje tylko do tej samej
+    // specyfikacji
+    std::uint64_t hash = 0;
+    for (auto* m : {&spec->proc, &spec->times, &spec->cost})
+      hash = hash * 1099511628211ull ^
+        hashBytes(reinterpret_cast<const char*>(m->data()),
+                  m->size() * sizeof(double));
+    return hash;
+  }
+
+  int saveCheckpoint(const std::string& path, std::uint64_t hash) {
+    // Zapis do pliku tymczasowego i zamiana nazwy - przerwanie w trakcie
+    // zapisu nie niszczy poprzedniej migawki
+    PerfTimer timer(PHASE_CHECKPOINT);
+    std::string temporaryPath = path + ".tmp";
+    {
+      CheckpointWriter out(temporaryPath);
+      CheckpointHeader header;
+      std::memset(&header, 0, sizeof header);
+      std::memcpy(header.magic, checkpointMagic, sizeof(header.magic));
+      header.version = checkpointVersion;
+      header.nTasks = nTasks;
+      header.nPEs = nPEs;
+      header.nChannels = nChannels;
+      header.nEdges = spec->taskGraph.getNumberOfEdges();
+      header.fillGaps = fillGaps;
+      header.tablesHash = hash;
+      header.t_max = t_max;
+      header.c_max = c_max;
+      out.write(header);
+      for (double value : {overallTime, overallCost, peCost, taskCost,
+                           channelCost})
+        out.write(value);
+      out.write(nAllocatedTasks);
+      out.write(x_y_z);
+      out.write(PE_instances_ids);
+      tasks.save(out);
+      instances.save(out);
+      if (!out.good()) {
+        std::cout << "The checkpoint cannot be written to " << temporaryPath
+                  << ".\n";
+        return -1;
+      }
+    }
+    if (std::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+      std::cout << "The checkpoint cannot be written to " << path << ".\n";
+      return -1;
+    }
+    LOG_AT(LOG_INFO)
+      *trace << "ResourceAllocator: checkpoint after " << nAllocatedTasks
+        << " tasks written to " << path << '\n';
+    return 0;
+  }
+
+  int writeCheckpoint(const std::string& path) {
+    // Migawka bieżącego stanu: zadania, jednostki z listami szyn i osiami
+    // czasu, liczniki jednostek, współczynniki oraz sumy czasu i kosztu.
+    // Stan strategii (policy) nie jest zapisywany - strategie ze stanem
+    // muszą go odtworzyć same.
+    return saveCheckpoint(path, tablesHash());
+  }
+
+  int readCheckpoint(const std::string& path) {
+    // Wznowienie z migawki writeCheckpoint / setCheckpoint: alokator musi
+    // być zbudowany z tej samej specyfikacji i z tymi samymi ustawieniami
+    // (max time, max cost, wypełnianie luk). Dalsze allocateAll pomija
+    // przydzielone już zadania, więc wynik jest taki sam jak bez przerwy.
+    // Przy błędzie stan alokatora się nie zmienia.
+    PerfTimer timer(PHASE_CHECKPOINT);
+    CheckpointReader in(path);
+    if (!in.good()) {
+      std::cout << "The checkpoint file cannot be opened.\n";
+      return -1;
+    }
+    CheckpointHeader header{};
+    in.read(header);
+    if (!in.good() ||
+        std::memcmp(header.magic, checkpointMagic, sizeof(header.magic)) != 0 ||
+        header.version != checkpointVersion) {
+      std::cout << path << ": not a valid checkpoint.\n";
+      return -1;
+    }
+    if (header.nTasks != nTasks || header.nPEs != nPEs ||
+        header.nChannels != nChannels ||
+        header.nEdges != spec->taskGraph.getNumberOfEdges() ||
+        header.tablesHash != tablesHash() || header.t_max != t_max ||
+        header.c_max != c_max || header.fillGaps != fillGaps) {
+      std::cout << path << ": the checkpoint was written for a different "
+        << "specification or settings.\n";
+      return -1;
+    }
+    double totals[5];
+    for (auto& value : totals)
+      in.read(value);
+    int allocatedTasks = 0;
+    Coefficients xyz{};
+    std::vector<int> instanceCounts{};
+    TaskState loadedTasks{};
+    InstanceState loadedInstances{};
+    in.read(allocatedTasks);
+    in.read(xyz);
+    in.read(instanceCounts);
+    loadedTasks.load(in);
+    loadedInstances.load(in);
+    if (!in.atEnd() || loadedTasks.size() != nTasks ||
+        instanceCounts.size() != PE_instances_ids.size()) {
+      std::cout << path << ": truncated checkpoint.\n";
+      return -1;
+    }
+    // Indeksy z pliku są dalej używane bez sprawdzania, więc przed
+    // zmianą stanu odrzucamy migawkę z wartościami spoza zakresu
+    if (!loadedTasks.isValid(loadedInstances.size()) ||
+        !loadedInstances.isValid(nPEs, nChannels)) {
+      std::cout << path << ": not a valid checkpoint.\n";
+      return -1;
+    }
+
+    overallTime = totals[0];
+    overallCost = totals[1];
+    peCost = totals[2];
+    taskCost = totals[3];
+    channelCost = totals[4];
+    nAllocatedTasks = allocatedTasks;
+    x_y_z = xyz;
+    PE_instances_ids = std::move(instanceCounts);
+    tasks = std::move(loadedTasks);
+    instances = std::move(loadedInstances);
+    // Struktury pochodne: jednostki wg typu, ich końce ostatnich zadań i
+    // tablica szyn jednostek (szyny podpinane w tej samej kolejności)
+    instanceChannels = InstanceChannelTable{};
+    instanceChannels.build(channelIndex);
+    for (int p = 0; p < nPEs; ++p) {
+      instancesOfType[p].clear();
+      lastEndTimes[p] = EndTimeIndex{};
+    }
+    for (int r = 0; r < instances.size(); ++r) {
+      int procID = instances.procID[r];
+      instanceChannels.addInstance();
+      for (auto channel : instances.channelIDs[r])
+        instanceChannels.add(r, channel, channels[channel].cost,
+                             channelIndex);
+      instancesOfType[procID].push_back(r);
+      lastEndTimes[procID].push(instances.lastTaskEndTime[r]);
+    }
+    // Wyniki przydzielonych już zadań trafiają do raportu w tej samej
+    // kolejności, w jakiej wypisałby je nieprzerwany allocateAll - czyli w
+    // porządku allocationOrder wyznaczonym, gdy nic nie było przydzielone
+    // (przydzielone zadania są jego początkiem)
+    std::vector<int> placed(nTasks, -1);
+    tasks.resourceID.swap(placed);
+    auto order = allocationOrder();
+    tasks.resourceID.swap(placed);
+    for (auto taskID : order) {
+      int r = tasks.resourceID[taskID];
+      if (r != -1)
+        record(RECORD_ALLOCATED, taskID, instances.procID[r],
+               instances.number[r], tasks.startTime[taskID],
+               tasks.endTime[taskID]);
+    }
+    LOG_AT(LOG_INFO)
+      *trace << "ResourceAllocator: resumed after " << nAllocatedTasks
+        << " tasks from " << path << '\n';
+    return 0;
+  }
+
+  int scoreTask(int taskID, int bestParentID) {
+    // Wybór typu PE jak w findBest_std, ale z rodzicem wyznaczonym raz i bez
+    // komunikatów - funkcja tylko czyta stan alokatora, więc może działać
+    // równolegle dla wielu zadań (strategie muszą wtedy pozwalać na
+    // współbieżne wywołania metod const)
+    perfCount(PERF_FIND_BEST_STD);
+    int parentProcID = bestParentID == -1 ? -1 :
+      instances.procID[tasks.resourceID[bestParentID]];
+    int bestResourceID = -1;
+    double minValue = 0;
+    for (int i = 0; i < nPEs; ++i) {
+      if (parentProcID != -1 &&
+          channelIndex.firstSharedChannel(parentProcID, i) == -1)
+        continue;
+      double value = scoring.standardised(spec->procStd[i][0], spec->costStd[taskID][i],
+                                          spec->timesStd[taskID][i], x_y_z);
+      if (bestResourceID == -1 || value < minValue) {
+        minValue = value;
+        bestResourceID = i;
+      }
+    }
+    return bestResourceID;
+  }
+
+  void allocateAllParallel(int nThreads) {
+    // Algorytm konstrukcyjny poziomami grafu (wavefront). Poziom to zadania,
+    // których wszyscy rodzice mają już zasoby - są od siebie niezależne.
+    // Dla każdego poziomu:
+    // 1) równolegle (pula nThreads wątków) wybierany jest rodzic i typ PE
+    //    każdego zadania - na podstawie stanu z początku poziomu, w tym
+    //    współczynników x_y_z;
+    // 2) jeden wątek zatwierdza wybory rosnąco po ID zadania: aktualizacja
+    //    współczynników, wybór lub utworzenie jednostki, szyny, czasy.
+    // Wynik nie zależy więc od liczby wątków ani ich przeplotu, ale może
+    // różnić się od allocateAll, gdzie każde zadanie widzi przydziały
+    // wszystkich wcześniejszych.
+    PerfTimer timer(PHASE_ALLOCATE);
+    const int minChunk = 256; // mniejsze porcje nie opłacają się wątkowi
+    std::vector<int> remaining(nTasks, 0); // nieprzydzieleni rodzice
+    std::vector<int> level{}, next{};
+    int nPending = 0;
+    for (int t = 0; t < nTasks; ++t) {
+      if (tasks.resourceID[t] != -1)
+        continue;
+      ++nPending;
+      for (auto parentID : spec->taskGraph.parents(t))
+        if (tasks.resourceID[parentID] == -1)
+          remaining[t]++;
+      if (remaining[t] == 0)
+        level.push_back(t);
+    }
+    ThreadPool pool(nThreads);
+    std::vector<int> parentIDs{}, procIDs{};
+    std::vector<std::future<void>> pending{};
+    while (!level.empty()) {
+      std::sort(level.begin(), level.end());
+      int n = level.size();
+      if (level.back() >= spec->timesStd.d1)
+        throw std::logic_error("T" + std::to_string(level.back()) + " was "
+          "inserted online and has no standardised data");
+      parentIDs.resize(n);
+      procIDs.resize(n);
+      auto score = [&](int from, int to) {
+        for (int k = from; k < to; ++k) {
+          int t = level[k];
+          parentIDs[k] = findAllParents(t).empty() ? -1 : findBestParent(t);
+          procIDs[k] = scoreTask(t, parentIDs[k]);
         }
-        // Updating the overall time and cost
-        recomputeOverallTimeAndCost();
+      };
+      int nChunks = std::min(pool.size(), (n + minChunk - 1) / minChunk);
+      if (nChunks <= 1) {
+        score(0, n);
       } else {
-        // Recursive execution
-        std::vector<int> parentsIDs = findAllParents(taskID);
-        for (auto parentID : parentsIDs)
-          if (tasks[parentID].resourceID == -1) allocate(parentID);
-        allocate(taskID);
+        pending.clear();
+        for (int c = 0; c < nChunks; ++c)
+          pending.push_back(pool.submit([&score, c, n, nChunks] {
+            score((long)n * c / nChunks, (long)n * (c + 1) / nChunks);
+          }));
+        for (auto& done : pending)
+          done.get();
+      }
+      next.clear();
+      for (int k = 0; k < n; ++k) {
+        int t = level[k];
+        perfCount(PERF_ALLOCATED_TASKS);
+        LOG_AT(LOG_INFO)
+          *trace << "ResourceAllocator::allocate(): Allocating resources for T"
+            << t << '\n';
+        updateCoefficients();
+        placeTask(t, procIDs[k], parentIDs[k]);
+        --nPending;
+        for (auto childID : spec->taskGraph.children(t))
+          if (tasks.resourceID[childID] == -1 && --remaining[childID] == 0)
+            next.push_back(childID);
       }
+      level.swap(next);
     }
+    if (nPending != 0)
+      throw std::invalid_argument("Task graph contains a cycle");
+    LOG_AT(LOG_INFO)
+      *trace << "ResourceAllocator::allocateAllParallel(): "
+        << instances.size() << " PE instances\n";
+  }
+
+  std::vector<double> upwardRanks() {
+    // rank(t) = średni czas t po typach PE + max po następnikach c
+    // (waga krawędzi / średnia przepustowość szyn + rank(c)),
+    // w odwrotnym porządku topologicznym
+    auto order = spec->taskGraph.topologicalOrder();
+    if ((int)order.size() != nTasks)
+      throw std::invalid_argument("Task graph contains a cycle");
+    double meanBandwidth = 0;
+    for (auto& channel : channels)
+      meanBandwidth += channel.bandwidth / nChannels;
+    std::vector<double> ranks(nTasks);
+    for (int i = nTasks - 1; i >= 0; --i) {
+      int t = order[i];
+      double meanTime = 0;
+      for (int p = 0; p < nPEs; ++p)
+        meanTime += spec->times[t][p] / nPEs;
+      auto children = spec->taskGraph.children(t);
+      auto weights = spec->taskGraph.childrenWeights(t);
+      double maxPath = 0;
+      for (int k = 0; k < (int)children.size(); ++k) {
+        double comm = meanBandwidth > 0 ? weights[k] / meanBandwidth : 0;
+        maxPath = std::max(maxPath, comm + ranks[children[k]]);
+      }
+      ranks[t] = meanTime + maxPath;
+    }
+    return ranks;
+  }
+
+  void allocateUpwardRank() {
+    // Szeregowanie listowe HEFT. Zadania są brane według malejącego upward
+    // rank (przy remisie mniejsze ID) spośród tych, których rodzice już są
+    // przydzieleni, i trafiają tam, gdzie najwcześniej się skończą. Dla
+    // każdego typu PE kandydatami są jednostki rodziców tego typu (dane od
+    // rodzica na tej samej jednostce nie wymagają transmisji) oraz jednostka
+    // wolna w chwili nadejścia wszystkich danych - istniejąca
+    // (lastEndTimes) albo nowa. Transmisja od rodzica z innej jednostki idzie
+    // najszybszą szyną łączącą oba typy PE. Zadanie jest dopisywane po
+    // ostatnim zadaniu jednostki (bez wypełniania luk). Przy równym czasie
+    // zakończenia wygrywa istniejąca jednostka, potem mniejszy procID.
+    // Zadania nieprzewidziane - jak w allocateMinTime - tylko na PE
+    // uniwersalnych. Koszt: O(E * P + V * P log V) dla P typów PE.
+    PerfTimer timer(PHASE_ALLOCATE);
+    const double infinity = std::numeric_limits<double>::infinity();
+    auto ranks = upwardRanks();
+    auto lowerPriority = [&ranks](int a, int b) {
+      return ranks[a] != ranks[b] ? ranks[a] < ranks[b] : a > b;
+    };
+    std::priority_queue<int, std::vector<int>, decltype(lowerPriority)>
+      ready(lowerPriority);
+    std::vector<int> remaining(nTasks);
+    for (int t = 0; t < nTasks; ++t) {
+      remaining[t] = spec->taskGraph.nParents(t);
+      if (remaining[t] == 0)
+        ready.push(t);
+    }
+    while (!ready.empty()) {
+      int t = ready.top();
+      ready.pop();
+      perfCount(PERF_ALLOCATED_TASKS);
+      auto parents = spec->taskGraph.parents(t);
+      auto weights = spec->taskGraph.parentsWeights(t);
+      double bestFinish = infinity, bestStart = 0;
+      int bestProcID = -1, bestInstance = -1; // -1: nowa jednostka
+      auto consider = [&](int procID, int instance, double start) {
+        double finish = start + spec->times[t][procID];
+        if (finish == infinity)
+          return;
+        if (finish < bestFinish ||
+            (finish == bestFinish && bestInstance == -1 && instance != -1)) {
+          bestFinish = finish;
+          bestStart = start;
+          bestProcID = procID;
+          bestInstance = instance;
+        }
+      };
+      for (int p = 0; p < nPEs; ++p) {
+        if (tasks.unpredicted[t] && spec->proc[p][2] != 1)
+          continue;
+        // Najpóźniejsze nadejście danych (arrival) ogółem oraz z jednostek
+        // innych niż ta, z której przychodzi najpóźniej
+        double latest = 0, secondLatest = 0;
+        int latestInstance = -1;
+        for (int k = 0; k < (int)parents.size(); ++k) {
+          int q = parents[k];
+          int rq = tasks.resourceID[q];
+          int channelID = channelIndex.fastestChannel(instances.procID[rq], p);
+          double arrival = channelID == -1 ? infinity : tasks.endTime[q] +
+            weights[k] / channels[channelID].bandwidth;
+          if (arrival > latest) {
+            if (rq != latestInstance)
+              secondLatest = latest;
+            latest = arrival;
+            latestInstance = rq;
+          } else if (rq != latestInstance && arrival > secondLatest) {
+            secondLatest = arrival;
+          }
+        }
+        for (auto q : parents) {
+          int rq = tasks.resourceID[q];
+          if (instances.procID[rq] != p)
+            continue;
+          // Dane od rodziców z rq są gotowe przed końcem ostatniego zadania rq
+          double others = rq == latestInstance ? secondLatest : latest;
+          consider(p, rq, std::max(others, instances.lastTaskEndTime[rq]));
+        }
+        if (latest < infinity) {
+          int position = lastEndTimes[p].lastBefore(latest, true);
+          consider(p, position == -1 ? -1 : instancesOfType[p][position],
+                   latest);
+        }
+      }
+      if (bestProcID == -1)
+        throw std::invalid_argument("T" + std::to_string(t) + " cannot be "
+          "connected to its parents on any PE type");
+      int r = bestInstance;
+      if (r == -1) {
+        r = instances.add(bestProcID, PE_instances_ids[2 + bestProcID]++);
+        instanceChannels.addInstance();
+        instancesOfType[bestProcID].push_back(r);
+        lastEndTimes[bestProcID].push(instances.lastTaskEndTime[r]);
+      }
+      tasks.resourceID[t] = r;
+      for (auto q : parents) {
+        int rq = tasks.resourceID[q];
+        if (rq == r)
+          continue;
+        int channelID = channelIndex.fastestChannel(instances.procID[rq],
+                                                    bestProcID);
+        if (!instanceChannels.contains(rq, channelID))
+          attachChannel(rq, channelID);
+        if (!instanceChannels.contains(r, channelID))
+          attachChannel(r, channelID);
+      }
+      // Każda nowa jednostka jest podpięta do jakiejś szyny (jak w allocate) -
+      // bez rodziców do szyny dla zadań bez rodzica
+      if (bestInstance == -1 && parents.empty() &&
+          channelIndex.rootChannel(bestProcID) != -1)
+        attachChannel(r, channelIndex.rootChannel(bestProcID));
+      tasks.startTime[t] = bestStart;
+      tasks.endTime[t] = bestFinish;
+      instances.lastTaskStartTime[r] = bestStart;
+      instances.lastTaskEndTime[r] = bestFinish;
+      lastEndTimes[bestProcID].set(instances.number[r], bestFinish);
+      record(RECORD_ALLOCATED, t, bestProcID, instances.number[r], bestStart,
+             bestFinish);
+      accountTask(t);
+      for (auto childID : spec->taskGraph.children(t))
+        if (--remaining[childID] == 0)
+          ready.push(childID);
+    }
+    if (nAllocatedTasks != nTasks)
+      throw std::invalid_argument("Task graph contains a cycle");
+    LOG_AT(LOG_INFO)
+      *trace << "ResourceAllocator::allocateUpwardRank(): "
+        << instances.size() << " PE instances\n";
   }
 
   void debug() {
     // Funkcja do debugowania. Wypisuje zawartość niektórych struktur, które
     // mamy w grafie zadań.
-    std::cerr << "ResourceAllocator::debug()\n";
-    std::cerr << "ResourceAllocator::tasks\n";
-    for (auto task : tasks)
-      std::cerr << "  unpredicted: " << task.unpredicted << "; id: " << task.id 
-      << "; reallocated: " 
-      << (task.reallocated ? "true" : "false") << "; resourceID: " 
-      << task.resourceID << '\n';
-    std::cerr << "\nResourceAllocator::channels\n";
+    *trace << "ResourceAllocator::debug()\n";
+    *trace << "ResourceAllocator::tasks\n";
+    for (int t = 0; t < tasks.size(); ++t)
+      *trace << "  unpredicted: " << (int)tasks.unpredicted[t] << "; id: " << t
+      << "; resourceID: " << tasks.resourceID[t] << '\n';
+    *trace << "\nResourceAllocator::channels\n";
     for (int i = 0; i < (int)channels.size(); ++i) {
-      std::cerr << "  name: CHAN" << i << ";\n    bandwidth: " 
+      *trace << "  name: CHAN" << i << ";\n    bandwidth: " 
         << channels[i].bandwidth << ";\n    cost: " 
         << channels[i].cost << "\n   connections: ";
       for (int j = 0; j < (int)channels[i].connections.size(); ++j)
-        std::cerr << (channels[i].connections[j] ? "↑" : "↓") << ' ';
-      std::cerr << "\n\n";
+        *trace << (channels[i].connections[j] ? "↑" : "↓") << ' ';
+      *trace << "\n\n";
     }
   }
 
   int findBest_timeCost(int taskID, bool unpredicted) {
-    std::vector<double> overallValues{};
-    std::vector<int> procIDs{};
-    for (int i = 0; i < proc.d1; ++i)
+    perfCount(PERF_FIND_BEST_TIME_COST);
+    auto& overallValues = scratchValues;
+    auto& procIDs = scratchProcIDs;
+    overallValues.clear();
+    procIDs.clear();
+    for (int i = 0; i < spec->proc.d1; ++i)
       if (unpredicted) {
-        if (proc[i][2] == 1) {
-          overallValues.push_back(times[taskID][i] * cost[taskID][i]);
+        if (spec->proc[i][2] == 1) {
+          overallValues.push_back(scoring.timeCost(spec->times[taskID][i],
+                                                   spec->cost[taskID][i]));
           procIDs.push_back(i);
         }
       } else {
-        overallValues.push_back(times[taskID][i] * cost[taskID][i]);
+        overallValues.push_back(scoring.timeCost(spec->times[taskID][i],
+                                                 spec->cost[taskID][i]));
         procIDs.push_back(i);
       }
     int bestResourceID = procIDs[0];
@@ -496,88 +1142,234 @@ class ResourceAllocator {
     return bestResourceID;
   }
 
-  double computeCriticalPath(int taskID) {
-    int nNextTasks = 0;
-    for (int i = 0; i < nTasks; ++i)
-      if (tasksAdjacencyMatrix[taskID][i])
-        nNextTasks++;
-    // Recursive break
-    if (nNextTasks == 0) {
-      double singleJobTime = times[taskID][tasks[taskID].resourceID];
-      tasks[taskID].pathTime = singleJobTime;
-      return singleJobTime;
-    }
-    // Recursive search
-    std::vector<double> possiblePathTimes{}; 
-    for (int i = 0; i < nTasks; ++i)
-      if (tasksAdjacencyMatrix[taskID][i])
-        possiblePathTimes.push_back(computeCriticalPath(i));
-    double maxTime = possiblePathTimes[0];
-    for (auto e : possiblePathTimes)
-      if (e > maxTime)
-        maxTime = e;
-    tasks[taskID].pathTime = maxTime;
-    return maxTime + times[taskID][tasks[taskID].resourceID];
+  void computeCriticalPaths() {
+    // Wyznacza czasy ścieżek krytycznych (najdłuższa ścieżka od zadania do
+    // końca grafu, łącznie z czasem samego zadania) dla wszystkich zadań
+    // jednym przejściem w odwrotnym porządku topologicznym (albo równolegle,
+    // patrz setCriticalPathThreads). resourceID
+    // zadania to tutaj procID wybrany przez allocateMinTime().
+    perfCount(PERF_COMPUTE_CRITICAL_PATHS);
+    PerfTimer timer(PHASE_CRITICAL_PATHS);
+    std::vector<double> durations(nTasks);
+    for (int t = 0; t < nTasks; ++t)
+      durations[t] = spec->times[t][tasks.resourceID[t]];
+    criticalPath.build(spec->taskGraph, std::move(durations), nPathThreads);
+    for (int t = 0; t < nTasks; ++t) {
+      if (tasks.scheduled[t])
+        criticalPath.markScheduled(t);
+      else
+        tasks.pathTime[t] = criticalPath.bottomLevel(t);
+    }
   }
 
   int findNextTaskInSchedule() {
-    int taskID = 0;
-    double maxTime = 0;
-    for (int i = 0; i < nTasks; ++i)
-      if (!tasks[i].scheduled)
-        tasks[i].pathTime = computeCriticalPath(i);
-    for (int i = 0; i < nTasks; ++i)
-      if (!tasks[i].scheduled && 
-        tasks[i].pathTime > maxTime) {
-        maxTime = tasks[i].pathTime;
-        taskID = i;
-      }
-    return taskID;      
+    // Zwraca nieposzeregowane zadanie o najdłuższej ścieżce krytycznej
+    // (przy remisie zadanie o najmniejszym ID)
+    return criticalPath.popNext();
+  }
+
+  int scheduleNextTask() {
+    // Szeregowanie po jednym zadaniu (np. w trakcie działania systemu, gdy
+    // mogą dochodzić nowe zadania - patrz insertUnpredictedTask). Wymaga
+    // wcześniejszego computeCriticalPaths(). Zwraca -1, jeśli wszystkie
+    // zadania są już poszeregowane.
+    int nextTask = findNextTaskInSchedule();
+    if (nextTask != -1) {
+      tasks.scheduled[nextTask] = true;
+      tasks.pathTime[nextTask] = -1;
+    }
+    return nextTask;
   }
 
   void scheduleAllTasks() {
+    PerfTimer timer(PHASE_SCHEDULE);
+    computeCriticalPaths();
     for (int i = 0; i < nTasks; ++i) {
-      int nextTask = findNextTaskInSchedule();
-      if (i == 0)
-        std::cout << "  ";
-      std::cout << (tasks[nextTask].unpredicted ? "u" : "") << "T" << nextTask;
-      if (i != nTasks - 1)
-        std::cout << " --> ";
-      tasks[nextTask].scheduled = true;
-      tasks[nextTask].pathTime = -1;
+      int nextTask = scheduleNextTask();
+      if (nextTask == -1)
+        break;
+      record(RECORD_SCHEDULED, nextTask, -1, -1, -1, -1);
     }
-    std::cout << '\n';
   }
 
   void allocateMinTime() {
     // Alokuje wszystkie zasoby zgodnie z kryterium "min(time * cost)", przy
     // czym nieprzewidziany zadania mają dostęp tylko do zasobow
     // uniwersalnych
+    PerfTimer timer(PHASE_ALLOCATE);
     for (int t = 0; t < nTasks; ++t) {
       int bestResourceID;
-      bestResourceID = findBest_timeCost(t, tasks[t].unpredicted);
-      tasks[t].resourceID = bestResourceID;
+      bestResourceID = findBest_timeCost(t, tasks.unpredicted[t]);
+      tasks.resourceID[t] = bestResourceID;
+      record(RECORD_TYPE, t, bestResourceID, -1, -1, -1);
+    }
+  }
 
-      std::string resourceLabel = "undefined_label";
-      if (proc[bestResourceID][2] == 0)
-        resourceLabel = "HC";
-      else
-        resourceLabel = "PP";
-      int PE_type_count = 1;
-      for (int i = 0; i < bestResourceID; ++i)
-        if (proc[i][2] == proc[bestResourceID][2]) PE_type_count++;
-      resourceLabel += std::to_string(PE_type_count);
+  void record(RecordKind kind, int taskID, int procID, int instance,
+              double startTime, double endTime) {
+    // Dopisuje wynik do raportu (bez formatowania)
+    if (report)
+      report->records.push_back(ReportRecord{taskID, procID, instance, kind,
+        tasks.unpredicted[taskID], startTime, endTime});
+  }
+
+  const std::string& typeLabel(int procID) {
+    // Etykieta typu zasobu, np. "HC2" albo "PP1"
+    return typeLabels[procID];
+  }
+
+  Label label(int resourceID) {
+    // Etykieta jednostki, np. "HC2_0" - składana dopiero przy wypisywaniu
+    return Label{typeLabels[instances.procID[resourceID]],
+                 instances.number[resourceID]};
+  }
 
-      std::cout << (tasks[t].unpredicted ? "  u" : "  ") << "T" << t << " --> " 
-        << resourceLabel << '\n';
+  bool createsCycle(const std::vector<std::pair<int, double>>& parents,
+                    const std::vector<std::pair<int, double>>& children) {
+    // Nowe zadanie p -> u -> c zamyka cykl, jeśli z któregoś następnika c da
+    // się dojść do któregoś z rodziców p. Przeszukujemy potomków następników.
+    // Gdy ścieżki krytyczne są już policzone, pomijamy zadania o bottom level
+    // mniejszym niż najmniejszy bottom level rodzica - z nich żadnego rodzica
+    // nie da się osiągnąć.
+    if (parents.empty() || children.empty())
+      return false;
+    std::vector<int> parentIDs{};
+    double bound = 0;
+    for (auto [parentID, data] : parents) {
+      parentIDs.push_back(parentID);
+      if (criticalPath.isBuilt() && (parentIDs.size() == 1 ||
+          criticalPath.bottomLevel(parentID) < bound))
+        bound = criticalPath.bottomLevel(parentID);
+    }
+    std::sort(parentIDs.begin(), parentIDs.end());
+    std::vector<char> visited(nTasks, false);
+    std::vector<int> stack{};
+    for (auto [childID, data] : children)
+      stack.push_back(childID);
+    while (!stack.empty()) {
+      int t = stack.back();
+      stack.pop_back();
+      if (visited[t] ||
+          (criticalPath.isBuilt() && criticalPath.bottomLevel(t) < bound))
+        continue;
+      visited[t] = true;
+      if (std::binary_search(parentIDs.begin(), parentIDs.end(), t))
+        return true;
+      for (auto child : spec->taskGraph.children(t))
+        stack.push_back(child);
     }
+    return false;
+  }
+
+  int insertUnpredictedTask(const std::vector<double>& taskTimes,
+                            const std::vector<double>& taskCosts,
+                            const std::vector<std::pair<int, double>>& parents,
+                            const std::vector<std::pair<int, double>>& children) {
+    // Dodaje w trakcie działania nowe zadanie nieprzewidziane (tryb 2) wraz
+    // z krawędziami: parents/children to pary (ID zadania, ilość danych).
+    // Zadanie dostaje zasób uniwersalny o najmniejszym czas * koszt. Jeśli
+    // szeregowanie już trwa, ścieżki krytyczne poprawiane są tylko dla
+    // przodków nowego zadania, a kolejne scheduleNextTask() uwzględnia je
+    // od razu. Następniki nie mogą być jeszcze poszeregowane. Tabele
+    // wystandaryzowane nie obejmują nowych zadań, więc algorytm
+    // konstrukcyjny nie może ich już przydzielić. Zwraca ID nowego zadania.
+    PerfTimer timer(PHASE_INSERT);
+    perfCount(PERF_INSERTED_TASKS);
+    if ((int)taskTimes.size() != nPEs || (int)taskCosts.size() != nPEs)
+      throw std::invalid_argument("Expected " + std::to_string(nPEs) +
+        " execution times and costs");
+    if (PE_instances_ids[1] == 0)
+      throw std::invalid_argument("There is no universal (PP) resource");
+    for (auto [parentID, data] : parents)
+      if (parentID < 0 || parentID >= nTasks)
+        throw std::invalid_argument("Parent T" + std::to_string(parentID)
+          + " does not exist");
+    for (auto [childID, data] : children) {
+      if (childID < 0 || childID >= nTasks)
+        throw std::invalid_argument("Child T" + std::to_string(childID)
+          + " does not exist");
+      if (tasks.scheduled[childID])
+        throw std::invalid_argument("Child T" + std::to_string(childID)
+          + " has already been scheduled");
+    }
+    if (createsCycle(parents, children))
+      throw std::invalid_argument("The new task would create a cycle");
+
+    int taskID = nTasks;
+    std::vector<Edge> edges{};
+    for (auto [parentID, data] : parents)
+      edges.push_back(Edge{parentID, taskID, data});
+    for (auto [childID, data] : children)
+      edges.push_back(Edge{taskID, childID, data});
+    auto& tables = mutableSpec();
+    tables.taskGraph.addTask(edges);
+    tables.times.appendRow(taskTimes);
+    tables.cost.appendRow(taskCosts);
+    tasks.add(true);
+    nTasks++;
+
+    int procID = findBest_timeCost(taskID, true);
+    tasks.resourceID[taskID] = procID;
+    if (criticalPath.isBuilt()) {
+      criticalPath.addTask(spec->taskGraph, taskID,
+                           spec->times[taskID][procID]);
+      tasks.pathTime[taskID] = criticalPath.bottomLevel(taskID);
+    }
+    record(RECORD_TYPE, taskID, procID, -1, -1, -1);
+    return taskID;
   }
 
   // Getter'y i Setter'y do zwracania atrybutów prywatnych
   double getOverallTime() { return overallTime; }
+  int getNumberOfTasks() { return nTasks; }
+  int getNumberOfInstances() { return instances.size(); }
+  void setGapFilling(bool fill) {
+    // true: zadanie może trafić do wolnej przerwy między zadaniami już
+    // przydzielonymi do jednostki (Timeline), a nie tylko po ostatnim z nich.
+    // Ustawiane przed allocate / allocateAll.
+    fillGaps = fill;
+  }
+  void setCheckpoint(const std::string& path, int interval) {
+    // allocateAll zapisuje migawkę stanu (writeCheckpoint) do path co
+    // interval przydzielonych zadań; 0 wyłącza migawki
+    checkpointPath = path;
+    checkpointInterval = interval;
+  }
+  void setCriticalPathThreads(int n) {
+    // Liczba wątków przejścia grafu w computeCriticalPaths (bottom level i
+    // earliest start, patrz traverseDag); wyniki nie zależą od n
+    nPathThreads = n;
+  }
+  double getEarliestStart(int taskID) {
+    // Najwcześniejszy start zadania bez czasów transmisji (po
+    // computeCriticalPaths)
+    return criticalPath.earliestStart(spec->taskGraph, taskID);
+  }
+  double getBottomLevel(int taskID) {
+    // Ścieżka krytyczna zadania według silnika (po computeCriticalPaths,
+    // także dla zadań wstawionych później)
+    return criticalPath.bottomLevel(taskID);
+  }
   double getOverallCost() { return overallCost; }
   void setMaxTime(double t) { t_max = t; }
   double getMaxTime() { return t_max; }
+  void setMaxCost(double c) { c_max = c; }
+  double getMaxCost() { return c_max; }
+  void setOutput(AllocationReport* report_, std::ostream& trace_) {
+    // Raport, do którego trafiają wyniki (formatowane dopiero przez
+    // writeReport), i strumień komunikatów diagnostycznych. Bez raportu
+    // (nullptr, np. przy przeglądzie parametrów) wyniki nie są zapisywane.
+    report = report_;
+    if (report)
+      report->typeLabels = typeLabels;
+    trace = &trace_;
+  }
+  // Obiekty strategii (dla strategii ze stanem, np. parametrów modelu kosztu)
+  Scoring& getScoring() { return scoring; }
+  CoefficientUpdate& getCoefficientUpdate() { return coefficientUpdate; }
+  ParentSelection& getParentSelection() { return parentSelection; }
 };
 
+using ResourceAllocator = BasicResourceAllocator<>;
+
 #endif
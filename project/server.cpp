@@ -0,0 +1,427 @@
+#include "server.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <poll.h>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include "batch.hpp"
+#include "loader.hpp"
+#include "threadPool.hpp"
+
+namespace {
+
+// Połączenie przez gniazdo z buforem odczytu (linie i bloki bajtów)
+class Connection {
+ private:
+  int fd;
+  std::string buffer{};
+
+  bool fill() {
+    char chunk[1 << 16];
+    ssize_t n;
+    do {
+      n = ::read(fd, chunk, sizeof chunk);
+    } while (n < 0 && errno == EINTR);
+    if (n <= 0)
+      return false;
+    buffer.append(chunk, n);
+    return true;
+  }
+ public:
+  explicit Connection(int fd_) : fd{fd_} {}
+  ~Connection() { ::close(fd); }
+  Connection(const Connection&) = delete;
+  Connection& operator=(const Connection&) = delete;
+
+  bool readLine(std::string& line) {
+    std::size_t end;
+    while ((end = buffer.find('\n')) == std::string::npos)
+      if (!fill())
+        return false;
+    line.assign(buffer, 0, end);
+    buffer.erase(0, end + 1);
+    if (!line.empty() && line.back() == '\r')
+      line.pop_back();
+    return true;
+  }
+  bool readBytes(std::size_t n, std::string& bytes) {
+    while (buffer.size() < n)
+      if (!fill())
+        return false;
+    bytes.assign(buffer, 0, n);
+    buffer.erase(0, n);
+    return true;
+  }
+  bool write(std::string_view data) {
+    while (!data.empty()) {
+      ssize_t n = ::send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+      if (n < 0 && errno == EINTR)
+        continue;
+      if (n <= 0)
+        return false;
+      data.remove_prefix(n);
+    }
+    return true;
+  }
+};
+
+bool socketAddress(const std::string& socketPath, sockaddr_un& address) {
+  address = sockaddr_un{};
+  address.sun_family = AF_UNIX;
+  if (socketPath.size() >= sizeof address.sun_path) {
+    std::cout << "The socket path is too long.\n";
+    return false;
+  }
+  socketPath.copy(address.sun_path, socketPath.size());
+  return true;
+}
+
+// Wczytane grafy: prototypy alokatora z wystandaryzowanymi tabelami
+class GraphCache {
+ private:
+  struct Entry {
+    std::shared_ptr<const ResourceAllocator> prototype;
+    bool uploaded; // przesłany przez PUT, a nie wczytany z pliku
+    std::filesystem::file_time_type modified;
+  };
+  std::mutex mutex;
+  std::map<std::string, Entry> entries;
+ public:
+  std::shared_ptr<const ResourceAllocator> get(const std::string& graph) {
+    std::error_code error;
+    std::filesystem::file_time_type modified{};
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      auto it = entries.find(graph);
+      if (it != entries.end() && it->second.uploaded)
+        return it->second.prototype;
+      modified = std::filesystem::last_write_time(graph, error);
+      if (error)
+        return nullptr;
+      if (it != entries.end() && it->second.modified == modified)
+        return it->second.prototype;
+    }
+    // Wczytanie poza sekcją krytyczną - inne zlecenia nie czekają na parser
+    std::shared_ptr<const ResourceAllocator> prototype =
+      loadResourceAllocator(graph, 0, 0, false);
+    if (!prototype)
+      return nullptr;
+    std::lock_guard<std::mutex> lock(mutex);
+    entries[graph] = Entry{prototype, false, modified};
+    return prototype;
+  }
+  bool put(const std::string& name, std::string_view text, int& nTasks) {
+    std::shared_ptr<ResourceAllocator> prototype =
+      parseResourceAllocator(name, text, 0, 0);
+    if (!prototype)
+      return false;
+    nTasks = prototype->getNumberOfTasks();
+    std::lock_guard<std::mutex> lock(mutex);
+    entries[name] = Entry{prototype, true, {}};
+    return true;
+  }
+  int size() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+  }
+};
+
+// Czasy obsługi ostatnich (co najwyżej maxSamples) zleceń w milisekundach
+class LatencyStats {
+ private:
+  static constexpr std::size_t maxSamples = 1 << 16;
+  std::mutex mutex;
+  std::vector<double> samples{};
+  long count = 0;
+ public:
+  void add(double milliseconds) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (samples.size() < maxSamples)
+      samples.push_back(milliseconds);
+    else
+      samples[count % maxSamples] = milliseconds;
+    ++count;
+  }
+  std::string report() {
+    std::vector<double> sorted{};
+    long n;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      sorted = samples;
+      n = count;
+    }
+    std::sort(sorted.begin(), sorted.end());
+    auto percentile = [&sorted](double p) {
+      if (sorted.empty())
+        return 0.0;
+      return sorted[std::min(sorted.size() - 1,
+                             (std::size_t)(p * sorted.size()))];
+    };
+    std::ostringstream result;
+    result << "requests: " << n << '\n'
+           << "p50_ms: " << percentile(0.50) << '\n'
+           << "p99_ms: " << percentile(0.99) << '\n';
+    return result.str();
+  }
+};
+
+struct Server {
+  GraphCache cache{};
+  LatencyStats latency{};
+  std::atomic<bool> stopping{false};
+  int listenFd = -1;
+  long maxPutBytes = defaultMaxPutBytes; // największa treść przyjmowana w PUT
+  int wakeFds[2] = {-1, -1}; // potok budzący pętlę accept przy zatrzymaniu
+  ThreadPool* pool = nullptr; // wykonuje zlecenia RUN
+  // Otwarte połączenia (zatrzymanie przerywa czekające na nich odczyty) i
+  // wątki połączeń, które już się zakończyły (do dołączenia)
+  std::mutex connectionsMutex;
+  std::set<int> connections{};
+  std::vector<int> finished{};
+
+  void stop() {
+    std::lock_guard<std::mutex> lock(connectionsMutex);
+    if (stopping.exchange(true))
+      return;
+    for (int fd : connections)
+      ::shutdown(fd, SHUT_RDWR);
+    char byte = 0;
+    [[maybe_unused]] auto written = ::write(wakeFds[1], &byte, 1);
+  }
+
+  std::string run(std::istringstream& request) {
+    std::string graph, rest;
+    double t_max, c_max;
+    int mode;
+    if (!(request >> graph >> t_max >> c_max >> mode) || request >> rest ||
+        mode < 1 || mode > 3)
+      return "error: expected RUN [graph] [max time] [max cost] [1/2/3]\n";
+    auto prototype = cache.get(graph);
+    if (!prototype)
+      return "error: the graph cannot be loaded\n";
+    // Kopia zawiera tylko stan przydziału - graf i tabele (także
+    // wystandaryzowane) są współdzielone z alokatorem w pamięci podręcznej
+    ResourceAllocator r{*prototype};
+    r.setMaxTime(t_max);
+    r.setMaxCost(c_max);
+    // Wyjątek z przydziału (np. cykl w grafie z PUT) to zwykła odpowiedź
+    // "error:" zakończona END, a nie zerwane połączenie
+    try {
+      return runJob(r, mode);
+    } catch (const std::exception& e) {
+      return "error: " + std::string(e.what()) + "\n";
+    }
+  }
+
+  std::string put(std::istringstream& request, Connection& connection,
+                  bool& closeConnection) {
+    std::string name, text, rest;
+    long nBytes;
+    if (!(request >> name >> nBytes) || request >> rest || nBytes < 0)
+      return "error: expected PUT [name] [bytes]\n";
+    if (nBytes > maxPutBytes) {
+      // Treść nie jest czytana, więc dalsza część strumienia nie jest już
+      // zleceniami - po odpowiedzi połączenie jest zamykane
+      closeConnection = true;
+      return "error: specification larger than " +
+             std::to_string(maxPutBytes) + " bytes\n";
+    }
+    if (!connection.readBytes(nBytes, text))
+      return "error: incomplete specification\n";
+    int nTasks = 0;
+    if (!cache.put(name, text, nTasks))
+      return "error: invalid specification\n";
+    return "loaded " + name + ": " + std::to_string(nTasks) + " tasks\n";
+  }
+
+  void serve(Connection& connection) {
+    for (std::string line; connection.readLine(line);) {
+      auto start = std::chrono::steady_clock::now();
+      std::istringstream request(line);
+      std::string command, response;
+      request >> command;
+      bool measured = true;
+      bool shutdownRequested = false;
+      bool closeConnection = false;
+      if (command == "RUN") {
+        // Przydział na puli; wątek połączenia tylko czeka na wynik
+        response = pool->submit([this, &request] {
+          return run(request);
+        }).get();
+      } else if (command == "PUT") {
+        response = put(request, connection, closeConnection);
+      } else if (command == "STATS") {
+        response = latency.report() +
+                   "cached_graphs: " + std::to_string(cache.size()) + '\n';
+        measured = false;
+      } else if (command == "SHUTDOWN") {
+        response = "bye\n";
+        measured = false;
+        shutdownRequested = true;
+      } else {
+        response = "error: unknown request '" + command + "'\n";
+        measured = false;
+      }
+      if (!connection.write(response + "END\n"))
+        return;
+      if (shutdownRequested) {
+        stop(); // po odpowiedzi, żeby klient ją dostał
+        return;
+      }
+      if (closeConnection)
+        return;
+      if (measured)
+        latency.add(std::chrono::duration<double, std::milli>(
+          std::chrono::steady_clock::now() - start).count());
+    }
+  }
+
+  void handle(int fd, int handlerID) {
+    // Wątek jednego połączenia: obsługuje je do końca (EOF klienta albo
+    // zatrzymanie serwera), a deskryptor jest zamykany dopiero po usunięciu
+    // z connections
+    {
+      Connection connection(fd);
+      {
+        std::lock_guard<std::mutex> lock(connectionsMutex);
+        if (stopping)
+          ::shutdown(fd, SHUT_RDWR);
+        connections.insert(fd);
+      }
+      serve(connection);
+      std::lock_guard<std::mutex> lock(connectionsMutex);
+      connections.erase(fd);
+    }
+    std::lock_guard<std::mutex> lock(connectionsMutex);
+    finished.push_back(handlerID);
+  }
+};
+
+}
+
+int runServer(const std::string& socketPath, int nThreads,
+              long maxPutBytes) {
+  sockaddr_un address;
+  if (!socketAddress(socketPath, address))
+    return -1;
+  Server server{};
+  server.maxPutBytes = maxPutBytes;
+  server.listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  ::unlink(socketPath.c_str());
+  if (server.listenFd < 0 ||
+      ::bind(server.listenFd, (sockaddr*)&address, sizeof address) < 0 ||
+      ::listen(server.listenFd, 64) < 0) {
+    std::cout << "Cannot listen on " << socketPath << ".\n";
+    if (server.listenFd >= 0)
+      ::close(server.listenFd);
+    return -1;
+  }
+  if (::pipe(server.wakeFds) < 0) {
+    std::cout << "Cannot create the server wake-up pipe.\n";
+    ::close(server.listenFd);
+    return -1;
+  }
+  std::cout << "Listening on " << socketPath << '\n';
+  {
+    // Każde połączenie ma własny wątek, więc bezczynni klienci nie blokują
+    // nowych połączeń; przydziały (RUN) wykonuje pula nThreads wątków
+    ThreadPool pool(nThreads);
+    server.pool = &pool;
+    std::map<int, std::thread> handlers{};
+    int nextHandlerID = 0;
+    while (!server.stopping) {
+      pollfd fds[2] = {{server.listenFd, POLLIN, 0},
+                       {server.wakeFds[0], POLLIN, 0}};
+      if (::poll(fds, 2, -1) < 0) {
+        if (errno == EINTR)
+          continue;
+        break;
+      }
+      {
+        std::lock_guard<std::mutex> lock(server.connectionsMutex);
+        for (int id : server.finished) {
+          handlers[id].join();
+          handlers.erase(id);
+        }
+        server.finished.clear();
+      }
+      if (server.stopping || !(fds[0].revents & POLLIN))
+        continue;
+      int fd = ::accept(server.listenFd, nullptr, nullptr);
+      if (fd < 0) {
+        if (errno == EINTR || errno == ECONNABORTED)
+          continue;
+        break;
+      }
+      int id = nextHandlerID++;
+      handlers.emplace(id, std::thread([&server, fd, id] {
+        server.handle(fd, id);
+      }));
+    }
+    // Zatrzymanie przerywa odczyty na otwartych połączeniach, więc wątki
+    // połączeń kończą się, a pula nie czeka na nic poza bieżącymi RUN
+    server.stop();
+    for (auto& [id, handler] : handlers)
+      handler.join();
+  }
+  ::close(server.wakeFds[0]);
+  ::close(server.wakeFds[1]);
+  ::close(server.listenFd);
+  ::unlink(socketPath.c_str());
+  return 0;
+}
+
+int runClient(const std::string& socketPath,
+              const std::vector<std::string>& request) {
+  sockaddr_un address;
+  if (request.empty() || !socketAddress(socketPath, address))
+    return -1;
+  int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0 || ::connect(fd, (sockaddr*)&address, sizeof address) < 0) {
+    std::cout << "Cannot connect to " << socketPath << ".\n";
+    if (fd >= 0)
+      ::close(fd);
+    return -1;
+  }
+  Connection connection(fd);
+
+  std::string message;
+  if (request[0] == "PUT" && request.size() == 3) {
+    // PUT [nazwa] [plik] - wysyłamy zawartość pliku
+    std::ifstream file(request[2], std::ios::binary);
+    if (!file.is_open()) {
+      std::cout << "The input file cannot be opened.\n";
+      return -1;
+    }
+    std::string text((std::istreambuf_iterator<char>(file)),
+                     std::istreambuf_iterator<char>());
+    message = "PUT " + request[1] + " " + std::to_string(text.size()) + "\n" +
+              text;
+  } else {
+    for (const auto& word : request)
+      message += (message.empty() ? "" : " ") + word;
+    message += '\n';
+  }
+  // Nieudany zapis nie kończy klienta: serwer mógł odrzucić zlecenie (np.
+  // za duży PUT) i zamknąć połączenie, a odpowiedź nadal jest do odczytania
+  bool failed = !connection.write(message);
+  for (std::string line; connection.readLine(line) && line != "END";) {
+    failed = failed || line.rfind("error:", 0) == 0;
+    std::cout << line << '\n';
+  }
+  return failed ? -1 : 0;
+}
@@ -0,0 +1,32 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <string>
+#include <vector>
+
+// Tryb serwera: program nasłuchuje na gnieździe Unix (AF_UNIX, SOCK_STREAM)
+// i wykonuje zlecenia bez uruchamiania nowego procesu. Wczytane grafy (wraz
+// z wystandaryzowanymi tabelami) zostają w pamięci między zleceniami -
+// każde zlecenie dostaje własny stan przydziału, a graf i tabele są
+// współdzielone (tylko do odczytu). Protokół jest tekstowy,
+// jedno zlecenie na linię, a każda odpowiedź kończy się linią "END":
+//   RUN [graf] [max time] [max cost] [1/2/3] - przydział (i szeregowanie);
+//       graf to nazwa przesłana wcześniej przez PUT albo ścieżka do pliku
+//       (tekstowego lub .tgb), przeładowywanego po zmianie pliku,
+//   PUT [nazwa] [liczba bajtów] + treść specyfikacji - zapamiętanie grafu
+//       (treść większa niż maxPutBytes jest odrzucana i serwer zamyka
+//       połączenie),
+//   STATS - liczba zleceń oraz mediana (p50) i p99 czasu ich obsługi,
+//   SHUTDOWN - zatrzymanie serwera (zamyka też pozostałe połączenia).
+// Każde połączenie ma własny wątek, a zlecenia RUN wykonuje pula nThreads
+// wątków, więc bezczynni klienci nie blokują pozostałych.
+const long defaultMaxPutBytes = 256l << 20;
+int runServer(const std::string& socketPath, int nThreads,
+              long maxPutBytes = defaultMaxPutBytes);
+
+// Klient do testów: wysyła jedno zlecenie (dla PUT [nazwa] [plik] przesyła
+// zawartość pliku) i wypisuje odpowiedź na std::cout.
+int runClient(const std::string& socketPath,
+              const std::vector<std::string>& request);
+
+#endif
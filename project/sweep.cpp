@@ -0,0 +1,100 @@
+#include "sweep.hpp"
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include "loader.hpp"
+#include "threadPool.hpp"
+
+std::vector<double> SweepRange::values() const {
+  std::vector<double> result{};
+  // Kolejne wartości liczone od from (a nie przez sumowanie kroków), żeby
+  // błąd zaokrągleń się nie kumulował
+  for (long i = 0; from + i * step <= to + step * 1e-9; ++i)
+    result.push_back(from + i * step);
+  return result;
+}
+
+bool parseSweepRange(const std::string& text, SweepRange& range) {
+  try {
+    auto first = text.find(':');
+    if (first == std::string::npos) {
+      range.from = range.to = std::stod(text);
+      range.step = 1;
+      return true;
+    }
+    auto second = text.find(':', first + 1);
+    if (second == std::string::npos)
+      return false;
+    range.from = std::stod(text.substr(0, first));
+    range.to = std::stod(text.substr(first + 1, second - first - 1));
+    range.step = std::stod(text.substr(second + 1));
+  } catch (const std::exception&) {
+    return false;
+  }
+  return range.step > 0 && range.from <= range.to;
+}
+
+int runSweep(const std::string& filepath, const SweepRange& times,
+             const SweepRange& costs, const std::string& csvPath,
+             int nThreads) {
+  auto base = loadResourceAllocator(filepath, times.from, costs.from, false);
+  if (!base)
+    return -1;
+  std::ofstream csv(csvPath);
+  if (!csv.is_open()) {
+    std::cout << "The output file cannot be opened.\n";
+    return -1;
+  }
+
+  std::vector<std::pair<double, double>> grid{};
+  for (auto t : times.values())
+    for (auto c : costs.values())
+      grid.push_back({t, c});
+
+  // Wynik punktu siatki; punkt, w którym przydział zgłosił wyjątek, ma
+  // w CSV czas i koszt "nan", a komunikat trafia na cout
+  struct PointResult {
+    double time;
+    double cost;
+    std::string error;
+  };
+  std::vector<std::future<PointResult>> results{};
+  {
+    ThreadPool pool(nThreads);
+    const ResourceAllocator& prototype = *base;
+    for (auto [t_max, c_max] : grid)
+      results.push_back(pool.submit([&prototype, t_max, c_max] {
+        // Każdy punkt ma własną kopię stanu alokatora (graf i tabele są
+        // współdzielone); bez raportu wyniki przydziału nie są zapisywane,
+        // a komunikaty trafiają do strumienia bez bufora (nic nie jest
+        // nawet formatowane)
+        ResourceAllocator r{prototype};
+        std::ostream discard(nullptr);
+        r.setOutput(nullptr, discard);
+        r.setMaxTime(t_max);
+        r.setMaxCost(c_max);
+        try {
+          r.allocateAll();
+        } catch (const std::exception& e) {
+          double nan = std::numeric_limits<double>::quiet_NaN();
+          return PointResult{nan, nan, e.what()};
+        }
+        return PointResult{r.getOverallTime(), r.getOverallCost(), ""};
+      }));
+  }
+
+  csv << std::setprecision(std::numeric_limits<double>::max_digits10);
+  csv << "max_time,max_cost,total_time,total_cost\n";
+  for (int i = 0; i < (int)grid.size(); ++i) {
+    auto [time, cost, error] = results[i].get();
+    if (!error.empty())
+      std::cout << "max time " << grid[i].first << ", max cost "
+                << grid[i].second << ": " << error << '\n';
+    csv << grid[i].first << ',' << grid[i].second << ',' << time << ','
+        << cost << '\n';
+  }
+  return 0;
+}
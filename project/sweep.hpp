@@ -0,0 +1,26 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <string>
+#include <vector>
+
+// Zakres wartości from:to:step (włącznie z to) albo pojedyncza wartość.
+struct SweepRange {
+  double from;
+  double to;
+  double step;
+  std::vector<double> values() const;
+};
+
+bool parseSweepRange(const std::string& text, SweepRange& range);
+
+// Przegląd parametrów: graf wczytywany jest raz, a dla każdego punktu siatki
+// (max time, max cost) niezależna kopia ResourceAllocator (ze wspólnymi
+// tabelami specyfikacji) wykonuje algorytm konstrukcyjny na puli nThreads
+// wątków. Wynik trafia do jednego pliku CSV
+// (max_time,max_cost,total_time,total_cost) w kolejności siatki.
+int runSweep(const std::string& filepath, const SweepRange& times,
+             const SweepRange& costs, const std::string& csvPath,
+             int nThreads);
+
+#endif
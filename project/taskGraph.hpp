@@ -0,0 +1,293 @@
+#ifndef TASK_GRAPH_H
+#define TASK_GRAPH_H
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Krawędź grafu zadań: from -> to z ilością danych do przesłania (weight).
+struct Edge {
+  int from;
+  int to;
+  double weight;
+};
+
+// Graf zadań w formacie CSR (compressed sparse row). Dla każdego zadania
+// trzymamy listę następników (children) i poprzedników (parents) wraz z
+// wagami krawędzi (ilość przesyłanych danych). Listy są posortowane rosnąco
+// po ID zadania, czyli w tej samej kolejności, w jakiej zwracało je
+// przeglądanie kolumny / wiersza macierzy sąsiedztwa. Budowany raz w
+// Parser::read. Pamięć rośnie z liczbą krawędzi, a nie z kwadratem liczby
+// zadań; wagę konkretnej krawędzi zwraca weight() w czasie O(1) dzięki
+// tablicy mieszającej (adresowanie otwarte) indeksowanej parą (from, to).
+// Lista każdego zadania to zakres [begin, end) w tablicach ID i wag, z
+// miejscem zarezerwowanym do limit. Po zbudowaniu listy leżą jedna za drugą
+// (offsets), a addTask dopisuje krawędź w miejscu albo przenosi listę na
+// koniec tablic z zapasem - koszt zamortyzowany to O(stopień zadania).
+class TaskGraph {
+ private:
+  struct Lists {
+    std::vector<int> offsets; // nTasks + 1, układ po build()/assign()
+    std::vector<int> begin;
+    std::vector<int> end;
+    std::vector<int> limit;
+    std::vector<int> ids;
+    std::vector<double> weights;
+
+    void packed() {
+      begin.assign(offsets.begin(), offsets.end() - 1);
+      end.assign(offsets.begin() + 1, offsets.end());
+      limit = end;
+    }
+    void addList() {
+      begin.push_back(ids.size());
+      end.push_back(ids.size());
+      limit.push_back(ids.size());
+    }
+    int insert(int taskID, int id, double weight) {
+      // Wstawia id do listy zadania taskID z zachowaniem kolejności
+      // rosnącej i zwraca jego pozycję
+      if (end[taskID] == limit[taskID]) {
+        // Brak miejsca - lista przenoszona jest na koniec tablic
+        int count = end[taskID] - begin[taskID];
+        int capacity = std::max(4, 2 * count);
+        int newBegin = ids.size();
+        ids.resize(newBegin + capacity);
+        weights.resize(newBegin + capacity);
+        std::copy(ids.begin() + begin[taskID], ids.begin() + end[taskID],
+                  ids.begin() + newBegin);
+        std::copy(weights.begin() + begin[taskID],
+                  weights.begin() + end[taskID], weights.begin() + newBegin);
+        begin[taskID] = newBegin;
+        end[taskID] = newBegin + count;
+        limit[taskID] = newBegin + capacity;
+      }
+      int k = std::lower_bound(ids.begin() + begin[taskID],
+                               ids.begin() + end[taskID], id) - ids.begin();
+      std::copy_backward(ids.begin() + k, ids.begin() + end[taskID],
+                         ids.begin() + end[taskID] + 1);
+      std::copy_backward(weights.begin() + k, weights.begin() + end[taskID],
+                         weights.begin() + end[taskID] + 1);
+      ids[k] = id;
+      weights[k] = weight;
+      end[taskID]++;
+      return k;
+    }
+  };
+  int nTasks;
+  int nEdges;
+  Lists children_;
+  Lists parents_;
+  std::vector<std::uint64_t> edgeKeys; // (from << 32 | to) + 1, 0 = puste
+  std::vector<int> edgeIndex;          // pozycja krawędzi w children_.weights
+  int edgeShift;
+
+  static std::uint64_t edgeKey(int from, int to) {
+    return ((std::uint64_t)(std::uint32_t)from << 32 | (std::uint32_t)to) + 1;
+  }
+  std::size_t slot(std::uint64_t key) const {
+    return (key * 0x9E3779B97F4A7C15ull) >> edgeShift;
+  }
+  std::size_t find(std::uint64_t key) const {
+    auto s = slot(key);
+    while (edgeKeys[s] != 0 && edgeKeys[s] != key)
+      s = (s + 1) & (edgeKeys.size() - 1);
+    return s;
+  }
+  void buildEdgeIndex() {
+    // Tablica o rozmiarze potęgi dwójki, wypełniona co najwyżej w połowie
+    int bits = 1;
+    while ((std::size_t(1) << bits) < 2 * std::size_t(nEdges)) ++bits;
+    edgeShift = 64 - bits;
+    edgeKeys.assign(std::size_t(1) << bits, 0);
+    edgeIndex.assign(std::size_t(1) << bits, -1);
+    for (int from = 0; from < nTasks; ++from)
+      for (int k = children_.begin[from]; k < children_.end[from]; ++k) {
+        auto key = edgeKey(from, children_.ids[k]);
+        auto s = find(key);
+        edgeKeys[s] = key;
+        edgeIndex[s] = k;
+      }
+  }
+  void insertEdge(int from, int to, double weight) {
+    children_.insert(from, to, weight);
+    parents_.insert(to, from, weight);
+    ++nEdges;
+    if (2 * std::size_t(nEdges) > edgeKeys.size()) {
+      buildEdgeIndex();
+      return;
+    }
+    // Pozycje krawędzi zadania from mogły się przesunąć
+    for (int k = children_.begin[from]; k < children_.end[from]; ++k) {
+      auto key = edgeKey(from, children_.ids[k]);
+      auto s = find(key);
+      edgeKeys[s] = key;
+      edgeIndex[s] = k;
+    }
+  }
+ public:
+  TaskGraph() : nTasks{0}, nEdges{0} {
+    children_.offsets.assign(1, 0);
+    parents_.offsets.assign(1, 0);
+    buildEdgeIndex();
+  }
+  ~TaskGraph() {}
+
+  void build(int nTasks_, std::vector<Edge> edges) {
+    // Powtórzona krawędź nadpisuje wagę (tak jak wpis w macierzy), więc
+    // zostawiamy ostatnie wystąpienie.
+    nTasks = nTasks_;
+    std::stable_sort(edges.begin(), edges.end(),
+      [](const Edge& a, const Edge& b) {
+        return a.from != b.from ? a.from < b.from : a.to < b.to;
+      });
+    std::vector<Edge> unique{};
+    unique.reserve(edges.size());
+    for (auto& e : edges)
+      if (!unique.empty() && unique.back().from == e.from &&
+          unique.back().to == e.to)
+        unique.back().weight = e.weight;
+      else
+        unique.push_back(e);
+    nEdges = unique.size();
+
+    // Następniki - krawędzie są już posortowane po (from, to)
+    auto& childOffsets = children_.offsets;
+    childOffsets.assign(nTasks + 1, 0);
+    children_.ids.resize(nEdges);
+    children_.weights.resize(nEdges);
+    for (auto& e : unique)
+      childOffsets[e.from + 1]++;
+    for (int i = 0; i < nTasks; ++i)
+      childOffsets[i + 1] += childOffsets[i];
+    for (int k = 0; k < nEdges; ++k) {
+      children_.ids[k] = unique[k].to;
+      children_.weights[k] = unique[k].weight;
+    }
+
+    // Poprzednicy - sortowanie przez zliczanie, stabilne względem from
+    auto& parentOffsets = parents_.offsets;
+    parentOffsets.assign(nTasks + 1, 0);
+    parents_.ids.resize(nEdges);
+    parents_.weights.resize(nEdges);
+    for (auto& e : unique)
+      parentOffsets[e.to + 1]++;
+    for (int i = 0; i < nTasks; ++i)
+      parentOffsets[i + 1] += parentOffsets[i];
+    std::vector<int> next(parentOffsets.begin(), parentOffsets.end() - 1);
+    for (auto& e : unique) {
+      int k = next[e.to]++;
+      parents_.ids[k] = e.from;
+      parents_.weights[k] = e.weight;
+    }
+    children_.packed();
+    parents_.packed();
+    buildEdgeIndex();
+  }
+
+  void assign(int nTasks_, std::span<const int> childOffsets_,
+              std::span<const int> childIDs_,
+              std::span<const double> childWeights_,
+              std::span<const int> parentOffsets_,
+              std::span<const int> parentIDs_,
+              std::span<const double> parentWeights_) {
+    // Wczytanie gotowych tablic CSR (np. z pliku .tgb) bez ponownego
+    // sortowania krawędzi
+    nTasks = nTasks_;
+    nEdges = childIDs_.size();
+    children_.offsets.assign(childOffsets_.begin(), childOffsets_.end());
+    children_.ids.assign(childIDs_.begin(), childIDs_.end());
+    children_.weights.assign(childWeights_.begin(), childWeights_.end());
+    parents_.offsets.assign(parentOffsets_.begin(), parentOffsets_.end());
+    parents_.ids.assign(parentIDs_.begin(), parentIDs_.end());
+    parents_.weights.assign(parentWeights_.begin(), parentWeights_.end());
+    children_.packed();
+    parents_.packed();
+    buildEdgeIndex();
+  }
+
+  int addTask(std::span<const Edge> edges) {
+    // Dopisuje zadanie o ID równym dotychczasowej liczbie zadań razem
+    // z krawędziami (każda zaczyna się albo kończy w nowym zadaniu, drugi
+    // koniec to istniejące zadanie). Zwraca ID nowego zadania. Surowe
+    // tablice CSR (get...Offsets) opisują dalej graf sprzed addTask.
+    int taskID = nTasks++;
+    children_.addList();
+    parents_.addList();
+    for (const auto& e : edges)
+      if (!hasEdge(e.from, e.to)) // powtórzona krawędź jest pomijana
+        insertEdge(e.from, e.to, e.weight);
+    return taskID;
+  }
+
+  // Surowe tablice CSR (do zapisu w pliku .tgb)
+  const std::vector<int>& getChildOffsets() const { return children_.offsets; }
+  const std::vector<int>& getChildIDs() const { return children_.ids; }
+  const std::vector<double>& getChildWeights() const {
+    return children_.weights;
+  }
+  const std::vector<int>& getParentOffsets() const { return parents_.offsets; }
+  const std::vector<int>& getParentIDs() const { return parents_.ids; }
+  const std::vector<double>& getParentWeights() const {
+    return parents_.weights;
+  }
+
+  int getNumberOfTasks() const { return nTasks; }
+  int getNumberOfEdges() const { return nEdges; }
+
+  double weight(int from, int to) const {
+    // Ilość danych przesyłanych krawędzią from -> to (0 jeśli krawędzi nie
+    // ma, tak jak w dawnej macierzy tasksMatrix)
+    auto s = find(edgeKey(from, to));
+    return edgeKeys[s] != 0 ? children_.weights[edgeIndex[s]] : 0;
+  }
+  bool hasEdge(int from, int to) const {
+    return edgeKeys[find(edgeKey(from, to))] != 0;
+  }
+
+  std::span<const int> children(int taskID) const {
+    return std::span<const int>(children_.ids.data() + children_.begin[taskID],
+      children_.end[taskID] - children_.begin[taskID]);
+  }
+  std::span<const double> childrenWeights(int taskID) const {
+    return std::span<const double>(
+      children_.weights.data() + children_.begin[taskID],
+      children_.end[taskID] - children_.begin[taskID]);
+  }
+  std::span<const int> parents(int taskID) const {
+    return std::span<const int>(parents_.ids.data() + parents_.begin[taskID],
+      parents_.end[taskID] - parents_.begin[taskID]);
+  }
+  std::span<const double> parentsWeights(int taskID) const {
+    return std::span<const double>(
+      parents_.weights.data() + parents_.begin[taskID],
+      parents_.end[taskID] - parents_.begin[taskID]);
+  }
+  std::vector<int> topologicalOrder() const {
+    // Porządek topologiczny (algorytm Kahna, kolejka FIFO inicjowana
+    // rosnąco po ID). Jeśli graf ma cykl, zwrócony wektor jest krótszy niż
+    // nTasks.
+    std::vector<int> indegree(nTasks);
+    std::vector<int> order{};
+    order.reserve(nTasks);
+    for (int t = 0; t < nTasks; ++t) {
+      indegree[t] = nParents(t);
+      if (indegree[t] == 0)
+        order.push_back(t);
+    }
+    for (int head = 0; head < (int)order.size(); ++head)
+      for (auto child : children(order[head]))
+        if (--indegree[child] == 0)
+          order.push_back(child);
+    return order;
+  }
+  int nChildren(int taskID) const {
+    return children_.end[taskID] - children_.begin[taskID];
+  }
+  int nParents(int taskID) const {
+    return parents_.end[taskID] - parents_.begin[taskID];
+  }
+};
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// Stała pula wątków z kolejką FIFO zadań. submit() zwraca std::future z
+// wynikiem zadania; destruktor czeka na wykonanie wszystkich zleconych zadań.
+class ThreadPool {
+ private:
+  std::vector<std::thread> workers;
+  std::queue<std::function<void()>> jobs;
+  std::mutex mutex;
+  std::condition_variable available;
+  bool stopping;
+
+  void work() {
+    while (true) {
+      std::function<void()> job;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        available.wait(lock, [this] { return stopping || !jobs.empty(); });
+        if (jobs.empty())
+          return;
+        job = std::move(jobs.front());
+        jobs.pop();
+      }
+      job();
+    }
+  }
+
+ public:
+  explicit ThreadPool(int nThreads) : stopping{false} {
+    if (nThreads < 1)
+      nThreads = 1;
+    for (int i = 0; i < nThreads; ++i)
+      workers.emplace_back([this] { work(); });
+  }
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    available.notify_all();
+    for (auto& worker : workers)
+      worker.join();
+  }
+
+  template<typename F>
+  auto submit(F f) -> std::future<decltype(f())> {
+    auto task = std::make_shared<std::packaged_task<decltype(f())()>>(
+      std::move(f));
+    auto result = task->get_future();
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      jobs.push([task] { (*task)(); });
+    }
+    available.notify_one();
+    return result;
+  }
+
+  int size() const { return workers.size(); }
+
+  static int defaultSize() {
+    int n = std::thread::hardware_concurrency();
+    return n > 0 ? n : 1;
+  }
+};
+
+#endif
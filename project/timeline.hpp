@@ -0,0 +1,208 @@
+#ifndef TIMELINE_H
+#define TIMELINE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "checkpoint.hpp"
+
+// Oś czasu jednej jednostki PE. Zamiast zajętych przedziałów trzymamy ich
+// dopełnienie - wolne przerwy [start, end), ostatnia kończy się w
+// nieskończoności. Przerwy są w drzewie BST (treap) uporządkowanym po
+// początku, a każdy węzeł pamięta najdłuższą przerwę w swoim poddrzewie.
+// Dzięki temu najwcześniejsze miejsce dla zadania o zadanym czasie trwania
+// (earliestStart) i rezerwacja przedziału (reserve) kosztują O(log n)
+// (oczekiwanie), gdzie n to liczba przerw. Priorytety węzłów są
+// deterministyczne, więc wynik nie zależy od uruchomienia. Puste drzewo
+// oznacza jednostkę jeszcze nieużywaną (jedna przerwa [0, nieskończoność)),
+// więc nieużywana oś czasu nie alokuje pamięci.
+class Timeline {
+ private:
+  struct Node {
+    double start;
+    double end;
+    double maxLength; // najdłuższa przerwa w poddrzewie
+    std::uint64_t priority;
+    int left;
+    int right;
+  };
+  std::vector<Node> nodes;
+  std::vector<int> freeNodes; // indeksy usuniętych węzłów do ponownego użycia
+  int root;
+  std::uint64_t seed;
+  double busyUntil; // koniec ostatniego zajętego przedziału
+
+  static constexpr double infinity = std::numeric_limits<double>::infinity();
+
+  int newNode(double start, double end) {
+    // splitmix64 - pseudolosowy, ale powtarzalny priorytet
+    std::uint64_t z = (seed += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    Node node{start, end, end - start, z ^ (z >> 31), -1, -1};
+    if (!freeNodes.empty()) {
+      int n = freeNodes.back();
+      freeNodes.pop_back();
+      nodes[n] = node;
+      return n;
+    }
+    nodes.push_back(node);
+    return nodes.size() - 1;
+  }
+  void update(int n) {
+    auto& node = nodes[n];
+    node.maxLength = node.end - node.start;
+    if (node.left != -1)
+      node.maxLength = std::max(node.maxLength, nodes[node.left].maxLength);
+    if (node.right != -1)
+      node.maxLength = std::max(node.maxLength, nodes[node.right].maxLength);
+  }
+  void split(int n, double key, int& left, int& right) {
+    // left: przerwy o początku < key, right: pozostałe
+    if (n == -1) {
+      left = right = -1;
+      return;
+    }
+    if (nodes[n].start < key) {
+      split(nodes[n].right, key, nodes[n].right, right);
+      left = n;
+    } else {
+      split(nodes[n].left, key, left, nodes[n].left);
+      right = n;
+    }
+    update(n);
+  }
+  int merge(int left, int right) {
+    if (left == -1 || right == -1)
+      return left == -1 ? right : left;
+    if (nodes[left].priority > nodes[right].priority) {
+      nodes[left].right = merge(nodes[left].right, right);
+      update(left);
+      return left;
+    }
+    nodes[right].left = merge(left, nodes[right].left);
+    update(right);
+    return right;
+  }
+  int eraseFirst(int n) {
+    if (nodes[n].left == -1) {
+      freeNodes.push_back(n);
+      return nodes[n].right;
+    }
+    nodes[n].left = eraseFirst(nodes[n].left);
+    update(n);
+    return n;
+  }
+  void insert(double start, double end) {
+    int left, right;
+    split(root, start, left, right);
+    root = merge(merge(left, newNode(start, end)), right);
+  }
+  void erase(double start) {
+    int left, right;
+    split(root, start, left, right);
+    root = merge(left, eraseFirst(right));
+  }
+  int floor(double time) const {
+    // Przerwa o największym początku <= time (-1 jeśli nie ma)
+    int result = -1;
+    for (int n = root; n != -1;)
+      if (nodes[n].start <= time) {
+        result = n;
+        n = nodes[n].right;
+      } else {
+        n = nodes[n].left;
+      }
+    return result;
+  }
+  int firstFit(int n, double after, double duration) const {
+    // Przerwa o najmniejszym początku > after i długości >= duration
+    if (n == -1 || nodes[n].maxLength < duration)
+      return -1;
+    if (nodes[n].start <= after)
+      return firstFit(nodes[n].right, after, duration);
+    int result = firstFit(nodes[n].left, after, duration);
+    if (result != -1)
+      return result;
+    if (nodes[n].end - nodes[n].start >= duration)
+      return n;
+    return firstFit(nodes[n].right, after, duration);
+  }
+ public:
+  Timeline() : nodes{}, freeNodes{}, root{-1}, seed{0}, busyUntil{0} {}
+  ~Timeline() {}
+
+  double earliestStart(double ready, double duration) const {
+    // Najwcześniejsza chwila >= ready, od której jednostka jest wolna przez
+    // duration (ostatnia przerwa jest nieskończona, więc zawsze istnieje)
+    if (root == -1)
+      return ready;
+    int n = floor(ready);
+    if (n != -1 && nodes[n].end - ready >= duration)
+      return ready;
+    return nodes[firstFit(root, ready, duration)].start;
+  }
+  void reserve(double start, double duration) {
+    // Zajmuje [start, start + duration); przedział musi mieścić się w jednej
+    // przerwie (czyli start pochodzi z earliestStart)
+    if (root == -1)
+      insert(0, infinity);
+    int n = floor(start);
+    double gapStart = nodes[n].start;
+    double gapEnd = nodes[n].end;
+    double end = start + duration;
+    erase(gapStart);
+    if (start > gapStart)
+      insert(gapStart, start);
+    if (gapEnd > end)
+      insert(end, gapEnd);
+    busyUntil = std::max(busyUntil, end);
+  }
+  double end() const { return busyUntil; }
+
+  void save(CheckpointWriter& out) const {
+    out.write(nodes);
+    out.write(freeNodes);
+    out.write(root);
+    out.write(seed);
+    out.write(busyUntil);
+  }
+  void load(CheckpointReader& in) {
+    in.read(nodes);
+    in.read(freeNodes);
+    in.read(root);
+    in.read(seed);
+    in.read(busyUntil);
+  }
+  bool isValid() const {
+    // Sprawdzenie wczytanej migawki: indeksy węzłów w zakresie, a węzły
+    // osiągalne z korzenia tworzą drzewo (bez cykli)
+    int size = nodes.size();
+    if (root < -1 || root >= size)
+      return false;
+    for (int n : freeNodes)
+      if (n < 0 || n >= size)
+        return false;
+    std::vector<char> visited(size, false);
+    std::vector<int> stack{};
+    if (root != -1)
+      stack.push_back(root);
+    while (!stack.empty()) {
+      int n = stack.back();
+      stack.pop_back();
+      if (visited[n])
+        return false;
+      visited[n] = true;
+      for (int child : {nodes[n].left, nodes[n].right}) {
+        if (child < -1 || child >= size)
+          return false;
+        if (child != -1)
+          stack.push_back(child);
+      }
+    }
+    return true;
+  }
+};
+
+#endif
@@ -0,0 +1,121 @@
+#ifndef TOKENIZER_H
+#define TOKENIZER_H
+
+#include <charconv>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+// Błąd składni pliku ze specyfikacją wraz z numerem linii (od 1).
+struct ParseError : std::runtime_error {
+  int line;
+  ParseError(int line_, const std::string& what)
+      : std::runtime_error(what), line{line_} {}
+};
+
+// Jednoprzebiegowy tokenizer dla formatu @tasks/@proc/@times/@cost/@comm.
+// Działa bezpośrednio na buforze (np. zmapowanym pliku), niczego nie kopiuje
+// i pamięta numer bieżącej linii na potrzeby komunikatów o błędach.
+class Tokenizer {
+ private:
+  const char* pos;
+  const char* end;
+  int lineNumber;
+
+  static bool isDigit(char c) { return c >= '0' && c <= '9'; }
+  static bool isBlank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+ public:
+  Tokenizer(const char* begin_, const char* end_)
+      : pos{begin_}, end{end_}, lineNumber{1} {}
+
+  int line() const { return lineNumber; }
+  [[noreturn]] void fail(const std::string& what) const {
+    throw ParseError(lineNumber, what);
+  }
+
+  void skipBlanks() {
+    while (pos != end && isBlank(*pos)) ++pos;
+  }
+  bool atEnd() const { return pos == end; }
+  bool atEndOfLine() {
+    // Czy w bieżącej linii nie ma już żadnego tokenu
+    skipBlanks();
+    return pos == end || *pos == '\n';
+  }
+  void nextLine() {
+    // Pomija resztę bieżącej linii, a następnie linie puste
+    while (pos != end && *pos != '\n') ++pos;
+    while (pos != end && *pos == '\n') {
+      ++pos;
+      ++lineNumber;
+      const char* p = pos;
+      while (p != end && isBlank(*p)) ++p;
+      if (p == end || *p != '\n')
+        break;
+      pos = p;
+    }
+  }
+  void expectEndOfLine() {
+    if (!atEndOfLine())
+      fail("unexpected '" + std::string(1, *pos) + "'");
+    nextLine();
+  }
+
+  char peek() {
+    skipBlanks();
+    return pos == end ? '\0' : *pos;
+  }
+  bool accept(char c) {
+    // Zjada znak c, jeśli jest następny (bez pomijania odstępów)
+    if (pos != end && *pos == c) {
+      ++pos;
+      return true;
+    }
+    return false;
+  }
+  void expect(char c) {
+    if (!accept(c))
+      fail(std::string("expected '") + c + "'");
+  }
+  std::string_view word() {
+    // Ciąg znaków alfanumerycznych i '@' (np. "@tasks", "CHAN0")
+    skipBlanks();
+    const char* start = pos;
+    while (pos != end && (isDigit(*pos) || *pos == '@' ||
+           (*pos >= 'a' && *pos <= 'z') || (*pos >= 'A' && *pos <= 'Z')))
+      ++pos;
+    return std::string_view(start, pos - start);
+  }
+  void expectWord(std::string_view w) {
+    if (word() != w)
+      fail("expected '" + std::string(w) + "'");
+  }
+
+  int readInt() {
+    // Nieujemna liczba całkowita (bez pomijania odstępów przed nią, żeby
+    // dało się wymusić np. "T12" bez spacji)
+    if (pos == end || !isDigit(*pos))
+      fail("expected an integer");
+    int value = 0;
+    auto [next, ec] = std::from_chars(pos, end, value);
+    if (ec != std::errc())
+      fail("integer out of range");
+    pos = next;
+    return value;
+  }
+  double readNumber() {
+    // Nieujemna liczba (całkowita albo dziesiętna) poprzedzona odstępami
+    skipBlanks();
+    if (pos == end || !isDigit(*pos))
+      fail("expected a number");
+    double value = 0;
+    auto [next, ec] = std::from_chars(pos, end, value);
+    if (ec != std::errc())
+      fail("number out of range");
+    pos = next;
+    return value;
+  }
+};
+
+#endif
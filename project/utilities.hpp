@@ -4,13 +4,21 @@
 #define UTILITIES_H
 
 #include "matrix.hpp"
+#include <array>
 #include <iostream>
 #include <cmath>
 #include <vector>
 #include <numeric>
 #include <math.h>
 
-auto standardiseData(Matrix<double> data, bool firstColumnOnly) {
+inline void standardiseData(const Matrix<double>& data, bool firstColumnOnly,
+                            Matrix<double>& result) {
+  // Zapisuje wystandaryzowane data do result (przy firstColumnOnly pozostałe
+  // kolumny są przepisywane bez zmian). result jest alokowany tylko wtedy,
+  // gdy ma inne wymiary niż data, więc ten sam bufor można wykorzystać
+  // ponownie dla kolejnej tabeli o tych samych wymiarach.
+  if (result.d1 != data.d1 || result.d2 != data.d2)
+    result.build(data.d1, data.d2);
   int d1 = data.d1;
   int d2 = firstColumnOnly ? 1 : data.d2;
   double mean = 0;
@@ -21,15 +29,16 @@ auto standardiseData(Matrix<double> data, bool firstColumnOnly) {
   for (int i = 0; i < d1; ++i)
     for (int j = 0; j < d2; ++j) std += std::pow(data[i][j] - mean, 2);
   std = std::sqrt(std / (d1 * d2));
-  for (int i = 0; i < d1; ++i)
-    for (int j = 0; j < d2; ++j) data[i][j] = (data[i][j] - mean) / std;
-  return data;
+  for (int i = 0; i < d1; ++i) {
+    for (int j = 0; j < d2; ++j) result[i][j] = (data[i][j] - mean) / std;
+    for (int j = d2; j < data.d2; ++j) result[i][j] = data[i][j];
+  }
 }
 
 // *****************************************************************************
 
-double computeUsingStd(double p, double c, double t, double x, double y,
-                       double z) {
+inline double computeUsingStd(double p, double c, double t, double x,
+                              double y, double z) {
   // Zwraca wynik wzoru na sumę składowych zależnych od standaryzowanych
   // danych i współczynników.
   return x * p + y * c + z * t;
@@ -37,47 +46,6 @@ double computeUsingStd(double p, double c, double t, double x, double y,
 
 // *****************************************************************************
 
-struct PE {
-  double totalActiveTime; // ile do tej pory zasob byl uzywany
-  int totalNumOfJobs; // dotychczasowa ilosc zadan
-  double lastTaskStartTime; 
-  double lastTaskEndTime; // kiedy zaczelo sie i skonczylo ostatnie zadanie
-  int procID;
-  std::string label;
-  std::vector<int> channelIDs;
-  PE(double totalActiveTime_, int totalNumOfJobs_, double lastTaskStartTime_,
-     double lastTaskEndTime_, int procID_, std::string label_)
-      : totalActiveTime{totalActiveTime_},
-        totalNumOfJobs{totalNumOfJobs_},
-        lastTaskStartTime{lastTaskStartTime_},
-        lastTaskEndTime{lastTaskEndTime_},
-        procID{procID_},
-        label{label_},
-        channelIDs{std::vector<int>()} {}
-  PE(int procID_, std::string label_) : PE(-1, -1, -1, -1, procID_, label_) {}
-};
-
-// *****************************************************************************
-
-struct Task {
-  int id;
-  int resourceID; // 1) ID zasobu obliczeniowego przypisanego do zadania przy
-                  // działaniu algorytmu konstrukcyjnego.
-                  // ALBO
-                  // 2) procID wybranego zasobu przy przydziału nieprzewidzanych
-                  // zadań.
-  bool reallocated; // czy zasob zostal juz zaalokowany czy tez nie
-  bool unpredicted; // czy zadanie jest nieprzewidziane czy nie
-  double pathTime = -1; // czas lokalnej ściezki krytycznej (-1 to undefined)
-  bool scheduled = false; // czy było poszeregowane czy nie
-  Task() : id{-1}, resourceID{-1}, reallocated{false}, unpredicted{false} {}
-  Task(int id_, int resourceID_, double pathTime_, bool u)
-      : id{id_}, resourceID{resourceID_}, reallocated{false}, 
-      unpredicted{u} {}
-  Task(int id_, bool u) : Task(id_, -1, -1, u) {}
-  ~Task() {}
-};
-
 // Informacje o kosztach są w tabelach costMatrix oraz procMatrix. 
 // Informacje o koszcie uzyskujemy z tych tabel biorąc pod uwagę task -ID oraz 
 // proc - ID.
@@ -96,7 +64,7 @@ struct Channel {
 
 // *****************************************************************************
 
-std::vector<double> softmax(double a, double b, double c) {
+inline std::array<double, 3> softmax(double a, double b, double c) {
   // Obliczamy wartości wykładnicze dla każdego współczynnika
   // std::exp jest używany do przekształcenia każdego elementu wejściowego
   // (współczynnika) w jego wartość wykładniczą.
@@ -108,9 +76,7 @@ std::vector<double> softmax(double a, double b, double c) {
   // Sumujemy wartości wykładnicze
   auto sum_exp = exp_a + exp_b + exp_c;
   // Obliczamy wartości softmax
-  std::vector<double> result = {exp_a / sum_exp, exp_b / sum_exp, 
-    exp_c / sum_exp};
-  return result;
+  return {exp_a / sum_exp, exp_b / sum_exp, exp_c / sum_exp};
 }
 
 #endif